@@ -3,5 +3,6 @@
 #define MYENGINE_ALGORITHM_H
 #include "Collider.h"
 #include "Draw.h"
+#include "Batch.h"
 
 #endif //MYENGINE_ALGORITHM_H
\ No newline at end of file
@@ -0,0 +1,278 @@
+#pragma once
+#ifndef MYENGINE_ALGORITHM_BATCH_H
+#define MYENGINE_ALGORITHM_BATCH_H
+#include "Draw.h"
+#if defined(__AVX__)
+#include <immintrin.h>
+#define MYENGINE_BATCH_AVX
+#define MYENGINE_BATCH_ISA Avx
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MYENGINE_BATCH_SSE
+#define MYENGINE_BATCH_ISA Sse2
+#else
+#define MYENGINE_BATCH_ISA Generic
+#endif
+
+namespace MyEngine {
+    namespace Algorithm {
+        /**
+         * @namespace Batch
+         * @brief Tessellation of many shapes in one call.
+         *
+         * Shapes are passed as structure of arrays and the vertices are computed with AVX or
+         * SSE, whichever the build targets, and one float at a time otherwise. The results
+         * match the single-shape `calc*` functions in `Draw.h`.
+         *
+         * The engine only includes this in `Renderer/Commands.cpp`. The kernels live in an
+         * inline namespace named after the instruction set, so a program that includes it
+         * with other flags gets its own copy instead of the engine's.
+         */
+        namespace Batch {
+        inline namespace MYENGINE_BATCH_ISA {
+            namespace Detail {
+                struct Scalar {
+                    static constexpr size_t LANES = 1;
+                    float v;
+                    static Scalar load(const float* ptr) { return {*ptr}; }
+                    static Scalar set(float value) { return {value}; }
+                    void store(float* ptr) const { *ptr = v; }
+                    friend Scalar operator+(Scalar a, Scalar b) { return {a.v + b.v}; }
+                    friend Scalar operator-(Scalar a, Scalar b) { return {a.v - b.v}; }
+                    friend Scalar operator*(Scalar a, Scalar b) { return {a.v * b.v}; }
+                };
+#if defined(MYENGINE_BATCH_AVX)
+                struct Pack {
+                    static constexpr size_t LANES = 8;
+                    __m256 v;
+                    static Pack load(const float* ptr) { return {_mm256_loadu_ps(ptr)}; }
+                    static Pack set(float value) { return {_mm256_set1_ps(value)}; }
+                    void store(float* ptr) const { _mm256_storeu_ps(ptr, v); }
+                    friend Pack operator+(Pack a, Pack b) { return {_mm256_add_ps(a.v, b.v)}; }
+                    friend Pack operator-(Pack a, Pack b) { return {_mm256_sub_ps(a.v, b.v)}; }
+                    friend Pack operator*(Pack a, Pack b) { return {_mm256_mul_ps(a.v, b.v)}; }
+                };
+#elif defined(MYENGINE_BATCH_SSE)
+                struct Pack {
+                    static constexpr size_t LANES = 4;
+                    __m128 v;
+                    static Pack load(const float* ptr) { return {_mm_loadu_ps(ptr)}; }
+                    static Pack set(float value) { return {_mm_set1_ps(value)}; }
+                    void store(float* ptr) const { _mm_storeu_ps(ptr, v); }
+                    friend Pack operator+(Pack a, Pack b) { return {_mm_add_ps(a.v, b.v)}; }
+                    friend Pack operator-(Pack a, Pack b) { return {_mm_sub_ps(a.v, b.v)}; }
+                    friend Pack operator*(Pack a, Pack b) { return {_mm_mul_ps(a.v, b.v)}; }
+                };
+#else
+                using Pack = Scalar;
+#endif
+
+                /// Points `i .. i + LANES` of a unit outline, scaled by (rx, ry), rotated and
+                /// moved to the center, are written to every `stride`-th vertex of `out`.
+                template<typename P>
+                inline void outline(const float* ux, const float* uy, size_t i, P cx, P cy, P rx, P ry,
+                                    P c, P s, SDL_Vertex* out, size_t stride) {
+                    alignas(32) float xs[P::LANES], ys[P::LANES];
+                    const P LX = P::load(ux + i) * rx, LY = P::load(uy + i) * ry;
+                    (cx + (LX * c - LY * s)).store(xs);
+                    (cy + (LX * s + LY * c)).store(ys);
+                    for (size_t j = 0; j < P::LANES; ++j) {
+                        out[(i + j) * stride].position = {xs[j], ys[j]};
+                    }
+                }
+
+                template<typename P>
+                inline void outlines(const float* ux, const float* uy, size_t count, float cx, float cy,
+                                     float rx, float ry, float c, float s, SDL_Vertex* out, size_t stride) {
+                    size_t i = 0;
+                    if constexpr (P::LANES > 1) {
+                        for (; i + P::LANES <= count; i += P::LANES) {
+                            outline<P>(ux, uy, i, P::set(cx), P::set(cy), P::set(rx), P::set(ry),
+                                       P::set(c), P::set(s), out, stride);
+                        }
+                    }
+                    for (; i < count; ++i) {
+                        outline<Scalar>(ux, uy, i, {cx}, {cy}, {rx}, {ry}, {c}, {s}, out, stride);
+                    }
+                }
+
+                /// Corner (sx * hw, sy * hh) of rectangles `k .. k + LANES`, rotated and moved
+                /// to their centers, is written to vertex `corner` of every rectangle.
+                template<typename P>
+                inline void corner(const float* cx, const float* cy, const float* hw, const float* hh,
+                                   const float* c, const float* s, size_t k, float sx, float sy, float inset,
+                                   SDL_Vertex* out, size_t stride, size_t corner) {
+                    alignas(32) float xs[P::LANES], ys[P::LANES];
+                    const P INSET = P::set(inset);
+                    const P X = P::set(sx) * (P::load(hw + k) - INSET);
+                    const P Y = P::set(sy) * (P::load(hh + k) - INSET);
+                    const P C = P::load(c + k), S = P::load(s + k);
+                    (P::load(cx + k) + (X * C - Y * S)).store(xs);
+                    (P::load(cy + k) + (X * S + Y * C)).store(ys);
+                    for (size_t j = 0; j < P::LANES; ++j) {
+                        out[(k + j) * stride + corner].position = {xs[j], ys[j]};
+                    }
+                }
+
+                inline constexpr float CORNER_SIGNS[4][2] = {{-1, -1}, {1, -1}, {1, 1}, {-1, 1}};
+
+                /// Moves `first_vertex` of every rectangle to `first_vertex + 4`, optionally inset by
+                /// `insets[k]`.
+                template<typename P>
+                inline void corners(const float* cx, const float* cy, const float* hw, const float* hh,
+                                    const float* c, const float* s, size_t k, const float* insets,
+                                    SDL_Vertex* out, size_t stride, size_t first_vertex) {
+                    for (size_t n = 0; n < 4; ++n) {
+                        const float SX = CORNER_SIGNS[n][0], SY = CORNER_SIGNS[n][1];
+                        if (!insets) {
+                            corner<P>(cx, cy, hw, hh, c, s, k, SX, SY, 0.f, out, stride, first_vertex + n);
+                            continue;
+                        }
+                        /// The inset differs per rectangle, so it is applied one lane at a time.
+                        for (size_t j = 0; j < P::LANES; ++j) {
+                            corner<Scalar>(cx, cy, hw, hh, c, s, k + j, SX, SY, insets[k + j],
+                                           out, stride, first_vertex + n);
+                        }
+                    }
+                }
+            }
+
+            /// Ellipses with the cos and sin of their rotation.
+            struct EllipseSoA {
+                std::vector<float> cx, cy, rx, ry, cos, sin;
+
+                void clear() {
+                    cx.clear(); cy.clear(); rx.clear(); ry.clear(); cos.clear(); sin.clear();
+                }
+                void push(const Vector2& center, const Size& radius, float degree) {
+                    float rot = degree * M_PI / 180.f;
+                    cx.push_back(center.x);
+                    cy.push_back(center.y);
+                    rx.push_back(radius.width);
+                    ry.push_back(radius.height);
+                    cos.push_back(cosf(rot));
+                    sin.push_back(sinf(rot));
+                }
+                [[nodiscard]] size_t size() const { return cx.size(); }
+            };
+
+            /// Rectangles as center, half size and the cos and sin of their rotation.
+            struct RectangleSoA {
+                std::vector<float> cx, cy, hw, hh, cos, sin;
+
+                void clear() {
+                    cx.clear(); cy.clear(); hw.clear(); hh.clear(); cos.clear(); sin.clear();
+                }
+                void push(const GeometryF& geometry, float degree) {
+                    float rad = degree * M_PI / 180.0f;
+                    hw.push_back(geometry.size.width * 0.5f);
+                    hh.push_back(geometry.size.height * 0.5f);
+                    cx.push_back(geometry.pos.x + hw.back());
+                    cy.push_back(geometry.pos.y + hh.back());
+                    cos.push_back(cosf(rad));
+                    sin.push_back(sinf(rad));
+                }
+                [[nodiscard]] size_t size() const { return cx.size(); }
+            };
+
+            /// `circle.segment + 2` vertices per ellipse, laid out as by `calcEllipse`.
+            inline void calcEllipses(const EllipseSoA& shapes, const UnitCircle& circle,
+                                     std::span<const SDL_FColor> colors, SDL_Vertex* vertices) {
+                const size_t PER_SHAPE = circle.segment + 2;
+                for (size_t k = 0; k < shapes.size(); ++k) {
+                    SDL_Vertex* out = vertices + k * PER_SHAPE;
+                    for (size_t i = 0; i < PER_SHAPE; ++i) {
+                        out[i].color = colors[k];
+                        out[i].tex_coord = {0, 0};
+                    }
+                    out[0].position = {shapes.cx[k], shapes.cy[k]};
+                    Detail::outlines<Detail::Pack>(circle.cos.data(), circle.sin.data(), circle.segment + 1,
+                                                   shapes.cx[k], shapes.cy[k], shapes.rx[k], shapes.ry[k],
+                                                   shapes.cos[k], shapes.sin[k], out + 1, 1);
+                }
+            }
+
+            /// `(circle.segment + 1) * 2` vertices per ellipse, laid out as by `calcEllipseRing`.
+            /// Every border must be smaller than both radii of its ellipse.
+            inline void calcEllipseRings(const EllipseSoA& shapes, const UnitCircle& circle,
+                                         std::span<const float> borders, std::span<const SDL_FColor> colors,
+                                         SDL_Vertex* vertices) {
+                const size_t COUNT = circle.segment + 1;
+                for (size_t k = 0; k < shapes.size(); ++k) {
+                    SDL_Vertex* out = vertices + k * COUNT * 2;
+                    for (size_t i = 0; i < COUNT * 2; ++i) {
+                        out[i].color = colors[k];
+                        out[i].tex_coord = {0, 0};
+                    }
+                    Detail::outlines<Detail::Pack>(circle.cos.data(), circle.sin.data(), COUNT,
+                                                   shapes.cx[k], shapes.cy[k], shapes.rx[k], shapes.ry[k],
+                                                   shapes.cos[k], shapes.sin[k], out, 2);
+                    Detail::outlines<Detail::Pack>(circle.cos.data(), circle.sin.data(), COUNT,
+                                                   shapes.cx[k], shapes.cy[k], shapes.rx[k] - borders[k],
+                                                   shapes.ry[k] - borders[k], shapes.cos[k], shapes.sin[k],
+                                                   out + 1, 2);
+                }
+            }
+
+            /// 4 vertices per rectangle, laid out as by `calcFilledRectangleRotated`.
+            inline void calcRectangles(const RectangleSoA& shapes, std::span<const SDL_FColor> colors,
+                                       SDL_Vertex* vertices) {
+                const size_t N = shapes.size();
+                for (size_t k = 0; k < N * 4; ++k) {
+                    vertices[k].color = colors[k / 4];
+                    vertices[k].tex_coord = {0, 0};
+                }
+                size_t k = 0;
+                using Detail::Pack;
+                if constexpr (Pack::LANES > 1) {
+                    for (; k + Pack::LANES <= N; k += Pack::LANES) {
+                        Detail::corners<Pack>(shapes.cx.data(), shapes.cy.data(), shapes.hw.data(), shapes.hh.data(),
+                                              shapes.cos.data(), shapes.sin.data(), k, nullptr, vertices, 4, 0);
+                    }
+                }
+                for (; k < N; ++k) {
+                    Detail::corners<Detail::Scalar>(shapes.cx.data(), shapes.cy.data(), shapes.hw.data(),
+                                                    shapes.hh.data(), shapes.cos.data(), shapes.sin.data(), k,
+                                                    nullptr, vertices, 4, 0);
+                }
+            }
+
+            /// 8 vertices per rectangle, laid out as by `calcRectangleRotated`: the outer
+            /// corners, then the inner ones, `borders[k] / 2` further in.
+            inline void calcRectangleBorders(const RectangleSoA& shapes, std::span<const float> borders,
+                                             std::span<const SDL_FColor> colors, SDL_Vertex* vertices) {
+                const size_t N = shapes.size();
+                for (size_t k = 0; k < N * 8; ++k) {
+                    vertices[k].color = colors[k / 8];
+                    vertices[k].tex_coord = {0, 0};
+                }
+                thread_local std::vector<float> insets;
+                insets.resize(N);
+                for (size_t k = 0; k < N; ++k) {
+                    insets[k] = borders[k] * 0.5f;
+                }
+                size_t k = 0;
+                using Detail::Pack;
+                if constexpr (Pack::LANES > 1) {
+                    for (; k + Pack::LANES <= N; k += Pack::LANES) {
+                        Detail::corners<Pack>(shapes.cx.data(), shapes.cy.data(), shapes.hw.data(), shapes.hh.data(),
+                                              shapes.cos.data(), shapes.sin.data(), k, nullptr, vertices, 8, 0);
+                        Detail::corners<Pack>(shapes.cx.data(), shapes.cy.data(), shapes.hw.data(), shapes.hh.data(),
+                                              shapes.cos.data(), shapes.sin.data(), k, insets.data(), vertices, 8, 4);
+                    }
+                }
+                for (; k < N; ++k) {
+                    Detail::corners<Detail::Scalar>(shapes.cx.data(), shapes.cy.data(), shapes.hw.data(),
+                                                    shapes.hh.data(), shapes.cos.data(), shapes.sin.data(), k,
+                                                    nullptr, vertices, 8, 0);
+                    Detail::corners<Detail::Scalar>(shapes.cx.data(), shapes.cy.data(), shapes.hw.data(),
+                                                    shapes.hh.data(), shapes.cos.data(), shapes.sin.data(), k,
+                                                    insets.data(), vertices, 8, 4);
+                }
+            }
+        }
+        }
+    }
+}
+
+#endif //MYENGINE_ALGORITHM_BATCH_H
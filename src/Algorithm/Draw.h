@@ -20,38 +20,150 @@ namespace MyEngine {
                     static_cast<uint8_t>(255 * color.a)};
         }
 
+        /// Moves already computed vertices instead of computing them again.
+        inline void translateVertices(std::span<SDL_Vertex> vertices, const Vector2& offset) {
+            for (auto& vertex : vertices) {
+                vertex.position.x += offset.x;
+                vertex.position.y += offset.y;
+            }
+        }
+
+        inline void recolorVertices(std::span<SDL_Vertex> vertices, const SDL_Color& color) {
+            const SDL_FColor FCOLOR = convert2FColor(color);
+            for (auto& vertex : vertices) {
+                vertex.color = FCOLOR;
+            }
+        }
+
+        /// Tables shared between shapes are cached for segment counts up to this one.
+        inline constexpr uint16_t MAX_CACHED_SEGMENT = 1024;
+
+        /// cos and sin of `segment + 1` evenly spaced angles over a full turn; the last
+        /// one repeats the first.
+        struct UnitCircle {
+            std::vector<float> cos, sin;
+            uint16_t segment{0};
+
+            void build(uint16_t new_segment) {
+                if (new_segment == segment && !cos.empty()) return;
+                segment = new_segment;
+                cos.resize(segment + 1);
+                sin.resize(segment + 1);
+                for (int i = 0; i <= segment; ++i) {
+                    float theta = segment ? 2.f * M_PI * i / segment : 0.f;
+                    cos[i] = cosf(theta);
+                    sin[i] = sinf(theta);
+                }
+            }
+        };
+
+        /// The shared table for `segment`. Tables up to `MAX_CACHED_SEGMENT` are built once
+        /// and kept for the rest of the program; larger ones are built per thread and stay
+        /// valid until the same thread asks for another large one.
+        inline const UnitCircle& unitCircle(uint16_t segment) {
+            static std::array<std::atomic<const UnitCircle*>, MAX_CACHED_SEGMENT + 1> tables{};
+            if (segment > MAX_CACHED_SEGMENT) {
+                thread_local UnitCircle table;
+                table.build(segment);
+                return table;
+            }
+            const UnitCircle* table = tables[segment].load(std::memory_order_acquire);
+            if (table) return *table;
+            auto fresh = new UnitCircle;
+            fresh->build(segment);
+            if (tables[segment].compare_exchange_strong(table, fresh, std::memory_order_acq_rel,
+                                                        std::memory_order_acquire)) {
+                return *fresh;
+            }
+            delete fresh;
+            return *table;
+        }
+
+        namespace Detail {
+            inline std::atomic<float> tessellation_tolerance{0.5f};
+        }
+
+        /// Largest distance, in pixels, allowed between a curve and the polygon drawn for
+        /// it when the segment count is picked automatically. Shapes pick it up the next
+        /// time their geometry is computed.
+        inline void setTessellationTolerance(float pixels) {
+            Detail::tessellation_tolerance.store(std::max(pixels, 0.01f), std::memory_order_relaxed);
+        }
+
+        inline float tessellationTolerance() {
+            return Detail::tessellation_tolerance.load(std::memory_order_relaxed);
+        }
+
+        inline constexpr uint16_t MIN_ADAPTIVE_SEGMENT = 8;
+        inline constexpr uint16_t MAX_ADAPTIVE_SEGMENT = 128;
+
+        /// The fewest segments that keep a circle of `radius` within `tolerance` of its
+        /// polygon: each chord may sag by `r * (1 - cos(pi / n))`.
+        inline uint16_t adaptiveSegment(float radius, float tolerance = tessellationTolerance()) {
+            if (radius <= tolerance) return MIN_ADAPTIVE_SEGMENT;
+            const float N = std::ceil(static_cast<float>(M_PI) / std::acos(1.f - tolerance / radius));
+            return static_cast<uint16_t>(std::clamp(N, static_cast<float>(MIN_ADAPTIVE_SEGMENT),
+                                                    static_cast<float>(MAX_ADAPTIVE_SEGMENT)));
+        }
+
+        /// `count + 1` vertices: the center, then the outline.
+        inline void calcPoint(const Vector2& position, float radius, const SDL_Color& color, uint16_t count,
+                              SDL_Vertex* vertices) {
+            const UnitCircle& circle = unitCircle(count);
+            const SDL_FColor fcolor = convert2FColor(color);
+            vertices[0] = {{position.x, position.y}, fcolor, {0, 0}};
+            for (uint16_t i = 0; i < count; ++i) {
+                vertices[i + 1] = {{position.x + circle.cos[i] * radius, position.y + circle.sin[i] * radius},
+                                   fcolor, {0, 0}};
+            }
+        }
+
+        /// A fan around the center (vertex 0) over `count` outline vertices, closed onto the first.
+        inline void calcPointIndices(uint16_t count, std::vector<int>& indices) {
+            indices.resize(count * 3);
+            for (uint16_t i = 0; i < count; ++i) {
+                indices[3 * i] = 0;
+                indices[3 * i + 1] = i + 1;
+                indices[3 * i + 2] = (i + 1) % count + 1;
+            }
+        }
+
         inline void calcPoint(const Vector2& position, float radius, SDL_Color color,
                       std::vector<SDL_Vertex>& vertices, std::vector<int>& indices,
                       const uint16_t count = 32) {
-            vertices.clear();
-            indices.clear();
-            
             const uint16_t actual_count = std::max(count, static_cast<uint16_t>(3));
-            
-            SDL_FColor fcolor = convert2FColor(color);
-            
-            vertices.push_back({{position.x, position.y}, fcolor, {0, 0}});
-            
-            for (uint16_t i = 0; i < actual_count; ++i) {
-                float angle = 2.0f * M_PI * static_cast<float>(i) / static_cast<float>(actual_count);
-                float x = position.x + cosf(angle) * radius;
-                float y = position.y + sinf(angle) * radius;
-                vertices.push_back({{x, y}, fcolor, {0, 0}});
-            }
-            
-            for (uint16_t i = 0; i < actual_count; ++i) {
-                indices.push_back(0);
-                indices.push_back(i + 1);
-                indices.push_back((i + 1) % actual_count + 1);
-            }
+            vertices.resize(actual_count + 1);
+            calcPoint(position, radius, color, actual_count, vertices.data());
+            calcPointIndices(actual_count, indices);
         }
 
-        inline void calcLine(float x1, float y1, float x2, float y2, uint16_t thickness, const SDL_Color &color,
-                             std::array<SDL_Vertex, 4> &vertex, std::array<int, 6> &indices) {
+        /// Two triangles for each of `N` quads of 4 vertices.
+        template<size_t N>
+        inline const std::array<int, N * 6>& quadIndices() {
+            static const std::array<int, N * 6> INDICES = [] {
+                std::array<int, N * 6> idx{};
+                for (int i = 0; i < static_cast<int>(N); ++i) {
+                    const int BASE = i * 4;
+                    idx[i * 6 + 0] = BASE;
+                    idx[i * 6 + 1] = BASE + 1;
+                    idx[i * 6 + 2] = BASE + 2;
+                    idx[i * 6 + 3] = BASE;
+                    idx[i * 6 + 4] = BASE + 2;
+                    idx[i * 6 + 5] = BASE + 3;
+                }
+                return idx;
+            }();
+            return INDICES;
+        }
+
+        /// Writes the 4 vertices of the quad, to be drawn with `quadIndices<1>()`. Returns
+        /// false, leaving `vertex` untouched, for a line of zero length.
+        inline bool calcLine(float x1, float y1, float x2, float y2, uint16_t thickness, const SDL_Color &color,
+                             SDL_Vertex* vertex) {
             float dx = x2 - x1;
             float dy = y2 - y1;
             float len = hypotf(dx, dy);
-            if (len == 0.0f) return;
+            if (len == 0.0f) return false;
 
             float nx = -dy / len;
             float ny = dx / len;
@@ -70,12 +182,13 @@ namespace MyEngine {
             vertex[1] = {{x1 + ex1 + px, y1 + ey1 + py}, fcolor, {0, 0}};
             vertex[2] = {{x2 + ex2 + px, y2 + ey2 + py}, fcolor, {0, 0}};
             vertex[3] = {{x2 + ex2 - px, y2 + ey2 - py}, fcolor, {0, 0}};
-            indices[0] = 0;
-            indices[1] = 1;
-            indices[2] = 2;
-            indices[3] = 0;
-            indices[4] = 2;
-            indices[5] = 3;
+            return true;
+        }
+
+        inline void calcLine(float x1, float y1, float x2, float y2, uint16_t thickness, const SDL_Color &color,
+                             std::array<SDL_Vertex, 4> &vertex, std::array<int, 6> &indices) {
+            if (!calcLine(x1, y1, x2, y2, thickness, color, vertex.data())) return;
+            indices = quadIndices<1>();
         }
 
         inline void calcRectangleBorder(const GeometryF& geometry, uint16_t border_size,
@@ -91,8 +204,9 @@ namespace MyEngine {
             borders[3] = {X + W - THICKNESS, Y + THICKNESS, THICKNESS, H - 2 * THICKNESS };
         }
 
+        /// 4 corners, to be drawn with `quadIndices<1>()`.
         inline void calcFilledRectangleRotated(const GeometryF& geometry, const SDL_Color& color, float degree,
-                                               std::array<SDL_Vertex, 4>& vertices, std::array<int, 6>& indices) {
+                                               std::array<SDL_Vertex, 4>& vertices) {
             float cx = geometry.pos.x + geometry.size.width  * 0.5f;
             float cy = geometry.pos.y + geometry.size.height * 0.5f;
 
@@ -108,25 +222,55 @@ namespace MyEngine {
 
             SDL_FColor fcolor = convert2FColor(color);
 
+            float rad = degree * M_PI / 180.0f;
+            float c = cosf(rad);
+            float s = sinf(rad);
+
             for (int i = 0; i < 4; ++i) {
                 float x = local[i].x;
                 float y = local[i].y;
 
-                float rad = degree * M_PI / 180.0f;
-                float c = cosf(rad);
-                float s = sinf(rad);
-
                 float wx = cx + (x * c - y * s);
                 float wy = cy + (x * s + y * c);
 
                 vertices[i] = { {wx, wy}, fcolor, {0, 0} };
             }
+        }
 
-            indices = { 0, 1, 2, 0, 2, 3 };
+        inline void calcFilledRectangleRotated(const GeometryF& geometry, const SDL_Color& color, float degree,
+                                               std::array<SDL_Vertex, 4>& vertices, std::array<int, 6>& indices) {
+            calcFilledRectangleRotated(geometry, color, degree, vertices);
+            indices = quadIndices<1>();
+        }
+
+        /// Two triangles per side between the outer corners (0-3) and the inner ones (4-7).
+        inline const std::array<int, 24>& rectangleBorderIndices() {
+            static const std::array<int, 24> INDICES = [] {
+                std::array<int, 24> idx{};
+                for (int i = 0; i < 4; ++i) {
+                    int n = i * 6;
+                    int o0 = i;
+                    int o1 = (i + 1) & 3;
+                    int i0 = i + 4;
+                    int i1 = ((i + 1) & 3) + 4;
+
+                    // Triangle 1
+                    idx[n + 0] = o0;
+                    idx[n + 1] = o1;
+                    idx[n + 2] = i1;
+                    // Triangle 2
+                    idx[n + 3] = o0;
+                    idx[n + 4] = i1;
+                    idx[n + 5] = i0;
+                }
+                return idx;
+            }();
+            return INDICES;
         }
 
+        /// Outer then inner corners, to be drawn with `rectangleBorderIndices()`.
         inline void calcRectangleRotated(const GeometryF& geometry, const SDL_Color& color, uint16_t size, float degree,
-                                         std::array<SDL_Vertex, 8>& vertices, std::array<int, 24>& indices) {
+                                         std::array<SDL_Vertex, 8>& vertices) {
             float cx = geometry.pos.x + geometry.size.width  * 0.5f;
             float cy = geometry.pos.y + geometry.size.height * 0.5f;
             float hw = geometry.size.width  * 0.5f;
@@ -161,96 +305,186 @@ namespace MyEngine {
                 vertices[i]     = { {ox, oy}, fcolor, {0, 0} };
                 vertices[i + 4] = { {ix, iy}, fcolor, {0, 0} };
             }
+        }
+
+        inline void calcRectangleRotated(const GeometryF& geometry, const SDL_Color& color, uint16_t size, float degree,
+                                         std::array<SDL_Vertex, 8>& vertices, std::array<int, 24>& indices) {
+            calcRectangleRotated(geometry, color, size, degree, vertices);
+            indices = rectangleBorderIndices();
+        }
 
-            int* idx = indices.data();
+        inline void calcSprite(const GeometryF& dest, const Vector2& center, double degree, SDL_FlipMode flip_mode,
+                               const SDL_FRect& tex_coord, const SDL_Color& color,
+                               std::array<SDL_Vertex, 4>& vertices) {
+            float u0 = tex_coord.x, v0 = tex_coord.y;
+            float u1 = tex_coord.x + tex_coord.w, v1 = tex_coord.y + tex_coord.h;
+            if (flip_mode & SDL_FLIP_HORIZONTAL) std::swap(u0, u1);
+            if (flip_mode & SDL_FLIP_VERTICAL) std::swap(v0, v1);
+
+            const float W = dest.size.width, H = dest.size.height;
+            const float px = dest.pos.x + center.x, py = dest.pos.y + center.y;
+            struct { float x, y, u, v; } local[4] = {
+                    { -center.x    , -center.y    , u0, v0 },   // LT
+                    { W - center.x , -center.y    , u1, v0 },   // RT
+                    { W - center.x , H - center.y , u1, v1 },   // RB
+                    { -center.x    , H - center.y , u0, v1 }    // LB
+            };
+
+            float c = 1.f, s = 0.f;
+            if (degree != 0.0) {
+                float rad = static_cast<float>(degree * M_PI / 180.0);
+                c = cosf(rad);
+                s = sinf(rad);
+            }
+            SDL_FColor fcolor = convert2FColor(color);
             for (int i = 0; i < 4; ++i) {
-                int n = i * 6;
-                int o0 = i;
-                int o1 = (i + 1) & 3;
-                int i0 = i + 4;
-                int i1 = ((i + 1) & 3) + 4;
-
-                // Triangle 1
-                idx[n + 0] = o0;
-                idx[n + 1] = o1;
-                idx[n + 2] = i1;
-                // Triangle 2
-                idx[n + 3] = o0;
-                idx[n + 4] = i1;
-                idx[n + 5] = i0;
+                vertices[i] = { {px + (local[i].x * c - local[i].y * s),
+                                 py + (local[i].x * s + local[i].y * c)},
+                                fcolor, {local[i].u, local[i].v} };
             }
         }
 
         inline void calcTriangle(const Vector2& pos1, const Vector2& pos2, const Vector2& pos3, const SDL_Color& color,
-                                 std::array<SDL_Vertex, 3>& vertices, std::array<int, 3>& indices) {
+                                 std::array<SDL_Vertex, 3>& vertices) {
             SDL_FColor fcolor = convert2FColor(color);
             vertices[0] = {{pos1.x, pos1.y}, fcolor};
             vertices[1] = {{pos2.x, pos2.y}, fcolor};
             vertices[2] = {{pos3.x, pos3.y}, fcolor};
-            indices[0] = 0;
-            indices[1] = 1;
-            indices[2] = 2;
         }
 
-        inline void calcEllipse(const Vector2& center_pt, const Size& radius, const SDL_Color& color,
-                                float degree, uint16_t segment, std::vector<SDL_Vertex>& vertices,
-                                std::vector<int>& indices) {
-            vertices.clear();
+        inline const std::array<int, 3>& triangleIndices() {
+            static const std::array<int, 3> INDICES = {0, 1, 2};
+            return INDICES;
+        }
+
+        inline void calcTriangle(const Vector2& pos1, const Vector2& pos2, const Vector2& pos3, const SDL_Color& color,
+                                 std::array<SDL_Vertex, 3>& vertices, std::array<int, 3>& indices) {
+            calcTriangle(pos1, pos2, pos3, color, vertices);
+            indices = triangleIndices();
+        }
+
+        /// A fan around the center (vertex 0) over `segment + 1` outline vertices.
+        inline void calcEllipseIndices(uint16_t segment, std::vector<int>& indices) {
+            indices.resize(segment * 3);
+            for (int i = 0; i < segment; ++i) {
+                indices[3 * i] = 0;
+                indices[3 * i + 1] = i + 1;
+                indices[3 * i + 2] = i + 2;
+            }
+        }
+
+        /// A strip between `segment + 1` interleaved outer and inner vertices, closed
+        /// back onto the first pair.
+        inline void calcEllipseRingIndices(uint16_t segment, std::vector<int>& indices) {
             indices.clear();
+            for (int i = 0; i < segment * 2; i += 2) {
+                indices.insert(indices.end(), { i, i + 1, i + 2,   i + 1, i + 3, i + 2 });
+            }
+
+            indices[indices.size() - 2] = 0;
+            indices[indices.size() - 1] = 1;
+        }
+
+        /// Index patterns that only depend on the segment count.
+        enum class Topology : uint8_t {
+            /// `calcPointIndices`
+            ClosedFan,
+            /// `calcEllipseIndices`
+            Fan,
+            /// `calcEllipseRingIndices`
+            Ring,
+            Count
+        };
+
+        /// The shared indices of `topology` for `segment`, cached like `unitCircle`.
+        inline std::span<const int> sharedIndices(Topology topology, uint16_t segment) {
+            using Table = std::array<std::atomic<const std::vector<int>*>, MAX_CACHED_SEGMENT + 1>;
+            static std::array<Table, static_cast<size_t>(Topology::Count)> tables{};
+            auto build = [topology, segment](std::vector<int>& indices) {
+                switch (topology) {
+                    case Topology::ClosedFan: calcPointIndices(segment, indices); break;
+                    case Topology::Fan: calcEllipseIndices(segment, indices); break;
+                    case Topology::Ring: calcEllipseRingIndices(segment, indices); break;
+                    default: indices.clear(); break;
+                }
+            };
+            if (segment > MAX_CACHED_SEGMENT) {
+                thread_local std::array<std::vector<int>, static_cast<size_t>(Topology::Count)> scratch;
+                auto& indices = scratch[static_cast<size_t>(topology)];
+                build(indices);
+                return indices;
+            }
+            auto& slot = tables[static_cast<size_t>(topology)][segment];
+            const std::vector<int>* indices = slot.load(std::memory_order_acquire);
+            if (indices) return *indices;
+            auto fresh = new std::vector<int>;
+            build(*fresh);
+            if (slot.compare_exchange_strong(indices, fresh, std::memory_order_acq_rel, std::memory_order_acquire)) {
+                return *fresh;
+            }
+            delete fresh;
+            return *indices;
+        }
+
+        /// `segment + 2` vertices: the center, then the outline, to be drawn with `Topology::Fan`.
+        inline void calcEllipse(const Vector2& center_pt, const Size& radius, const SDL_Color& color,
+                                float degree, uint16_t segment, SDL_Vertex* vertices) {
             auto colorF = convert2FColor(color);
             float rot = degree * M_PI / 180.f;
             float cosRot = cosf(rot), sinRot = sinf(rot);
 
-            vertices.resize(segment + 2);
+            const UnitCircle& circle = unitCircle(segment);
             vertices[0] = { {center_pt.x, center_pt.y}, colorF, {0, 0} };
             for (int i = 0; i <= segment; ++i) {
-                float theta = 2.f * M_PI * i / segment;
-                float x = radius.width * cosf(theta);
-                float y = radius.height * sinf(theta);
+                float x = radius.width * circle.cos[i];
+                float y = radius.height * circle.sin[i];
                 vertices[i + 1] = SDL_Vertex{{ center_pt.x + x * cosRot - y * sinRot,
                                center_pt.y + x * sinRot + y * cosRot },
                                              colorF, {0, 0} };
             }
-            indices.resize(segment * 3);
-            for (int i = 0; i < segment; ++i) {
-                indices[3 * i] = 0;
-                indices[3 * i + 1] = i + 1;
-                indices[3 * i + 2] = i + 2;
-            }
         }
 
-        inline void calcEllipseRing(const Vector2& center_pt, const Size& radius, uint16_t border_size,
+        inline void calcEllipse(const Vector2& center_pt, const Size& radius, const SDL_Color& color,
+                                float degree, uint16_t segment, std::vector<SDL_Vertex>& vertices,
+                                std::vector<int>& indices) {
+            vertices.resize(segment + 2);
+            calcEllipse(center_pt, radius, color, degree, segment, vertices.data());
+            calcEllipseIndices(segment, indices);
+        }
+
+        /// `(segment + 1) * 2` interleaved outer and inner vertices, to be drawn with
+        /// `Topology::Ring`. Returns false, writing nothing, if the border fills the ellipse.
+        inline bool calcEllipseRing(const Vector2& center_pt, const Size& radius, uint16_t border_size,
                                     const SDL_Color& border_color, float degree, uint16_t segment,
-                                    std::vector<SDL_Vertex>& vertices, std::vector<int>& indices) {
+                                    SDL_Vertex* vertices) {
             float rx2 = radius.width - border_size, ry2 = radius.height - border_size;
-            if (rx2 <= 0 || ry2 <= 0) return;
+            if (rx2 <= 0 || ry2 <= 0) return false;
             auto colorF = convert2FColor(border_color);
-            vertices.clear();
-            indices.clear();
 
             float rot = degree * M_PI / 180.f;
             float cosR = cosf(rot), sinR = sinf(rot);
 
-            vertices.reserve((segment + 1) * 2);
+            const UnitCircle& circle = unitCircle(segment);
             for (int i = 0; i <= segment; ++i) {
-                float theta = 2.f * M_PI * i / segment;
-                float ex = radius.width * cosf(theta);
-                float ey = radius.height * sinf(theta);
-                float ix = rx2 * cosf(theta);
-                float iy = ry2 * sinf(theta);
-                vertices.push_back({ {center_pt.x + ex * cosR - ey * sinR,
-                                      center_pt.y + ex * sinR + ey * cosR}, colorF,
-                                     {0,0} });
-                vertices.push_back({ {center_pt.x + ix * cosR - iy * sinR,
-                               center_pt.y + ix * sinR + iy * cosR}, colorF, {0,0} });
-            }
-
-            for (int i = 0; i < segment * 2; i += 2) {
-                indices.insert(indices.end(), { i, i + 1, i + 2,   i + 1, i + 3, i + 2 });
+                float ex = radius.width * circle.cos[i];
+                float ey = radius.height * circle.sin[i];
+                float ix = rx2 * circle.cos[i];
+                float iy = ry2 * circle.sin[i];
+                vertices[2 * i] = { {center_pt.x + ex * cosR - ey * sinR,
+                                     center_pt.y + ex * sinR + ey * cosR}, colorF, {0,0} };
+                vertices[2 * i + 1] = { {center_pt.x + ix * cosR - iy * sinR,
+                                         center_pt.y + ix * sinR + iy * cosR}, colorF, {0,0} };
             }
+            return true;
+        }
 
-            indices[indices.size() - 2] = 0;
-            indices[indices.size() - 1] = 1;
+        inline void calcEllipseRing(const Vector2& center_pt, const Size& radius, uint16_t border_size,
+                                    const SDL_Color& border_color, float degree, uint16_t segment,
+                                    std::vector<SDL_Vertex>& vertices, std::vector<int>& indices) {
+            if (radius.width <= border_size || radius.height <= border_size) return;
+            vertices.resize((segment + 1) * 2);
+            calcEllipseRing(center_pt, radius, border_size, border_color, degree, segment, vertices.data());
+            calcEllipseRingIndices(segment, indices);
         }
     }
 }
@@ -1277,100 +1277,144 @@ namespace MyEngine {
      * Includes all basic shapes, such as points, line segments, rectangles, ellipses, and other basic shapes.
      */
     namespace Graphics {
+        /// Parts of a shape's vertex data that are out of date. Setters only mark what
+        /// changed; the vertices are brought up to date once, when they are read for
+        /// rendering. Moves are kept as an offset and added to the existing vertices.
+        enum DirtyFlag : uint8_t {
+            DirtyNone = 0x0,
+            DirtyFill = 0x1,
+            DirtyBorder = 0x2,
+            DirtyFillColor = 0x4,
+            DirtyBorderColor = 0x8,
+            DirtyAll = 0xF
+        };
+
+        /// A filled circle. Its vertices are not stored but generated whenever they are
+        /// requested, and the indices are shared by all points with the same segment count.
         class Point {
-        private:
-            void update() {
-                _count = std::min(64, std::max(4, int(M_PI * _size / 2)));
-                Algorithm::calcPoint(_position, _size / 2.f,
-                                           _color, _vertices, _indices, _count);
-            }
-            Vector2 _position;
-            uint16_t _size;
-            SDL_Color _color;
-            std::vector<SDL_Vertex> _vertices;
-            std::vector<int> _indices;
-            uint16_t _count{32};
         public:
-            explicit Point() : _position(0, 0), _size(1), _color(StdColor::Black), _count(32) { update(); }
+            /// A `segment` of 0 picks the count from the size, see `Algorithm::adaptiveSegment`.
+            explicit Point() : _position(0, 0), _size(1), _color(StdColor::Black), _segment(0) {}
             Point(float x, float y, uint16_t size = 1, const SDL_Color& color = StdColor::Black,
-                  uint16_t count = 32)
-                : _position(x, y), _size(size), _color(color), _count(count) { update(); }
-            void move(float x, float y) { _position.reset(x, y); update(); }
-            void move(const Vector2& new_pos) { _position.reset(new_pos); update(); }
-            void resize(uint16_t new_size) { _size = new_size; update(); }
-            void setColor(const SDL_Color& color) { _color = color; update(); }
-            void setSegment(uint16_t segment = 32) { _count = segment; }
-            void reset(const Vector2& pos, uint16_t size, const SDL_Color& color, uint16_t segment = 32) {
+                  uint16_t count = 0)
+                : _position(x, y), _size(size), _color(color), _segment(count) {}
+            void move(float x, float y) { _position.reset(x, y); }
+            void move(const Vector2& new_pos) { _position.reset(new_pos); }
+            void resize(uint16_t new_size) { _size = new_size; }
+            void setColor(const SDL_Color& color) { _color = color; }
+            void setSegment(uint16_t segment = 0) { _segment = segment; }
+            void reset(const Vector2& pos, uint16_t size, const SDL_Color& color, uint16_t segment = 0) {
                 _position.reset(pos);
                 _size = size;
                 _color = color;
-                _count = segment;
-                update();
+                _segment = segment;
             }
-            void reset(float x, float y, uint16_t size, const SDL_Color& color, uint16_t segment = 32) {
+            void reset(float x, float y, uint16_t size, const SDL_Color& color, uint16_t segment = 0) {
                 _position.reset(x, y);
                 _size = size;
                 _color = color;
-                _count = segment;
-                update();
+                _segment = segment;
             }
             [[nodiscard]] const Vector2& position() const { return _position; }
             [[nodiscard]] uint16_t size() const { return _size; }
             [[nodiscard]] const SDL_Color& color() const { return _color; }
-            [[nodiscard]] const SDL_Vertex* vertices() const { return _vertices.data(); }
-            [[nodiscard]] const int* indices() const { return _indices.data(); }
-            [[nodiscard]] size_t verticesCount() const { return _vertices.size(); }
-            [[nodiscard]] size_t indicesCount() const { return _indices.size(); }
+            /// The segment count the geometry is generated with.
+            [[nodiscard]] uint16_t segment() const {
+                return std::max<uint16_t>(_segment ? _segment : Algorithm::adaptiveSegment(_size / 2.f), 3);
+            }
+            /// Writes `verticesCount()` vertices to `out`.
+            void fillVertices(SDL_Vertex* out) const {
+                Algorithm::calcPoint(_position, _size / 2.f, _color, segment(), out);
+            }
+            /// Generated into a buffer of the calling thread, valid until its next call.
+            [[nodiscard]] const SDL_Vertex* vertices() const {
+                thread_local std::vector<SDL_Vertex> scratch;
+                scratch.resize(verticesCount());
+                fillVertices(scratch.data());
+                return scratch.data();
+            }
+            [[nodiscard]] const int* indices() const {
+                return Algorithm::sharedIndices(Algorithm::Topology::ClosedFan, segment()).data();
+            }
+            [[nodiscard]] size_t verticesCount() const { return segment() + 1; }
+            [[nodiscard]] size_t indicesCount() const { return segment() * 3; }
+            /// Axis-aligned box around everything the shape draws.
+            [[nodiscard]] SDL_FRect bounds() const {
+                const float R = std::max(_size / 2.f, 1.f);
+                return {_position.x - R, _position.y - R, R * 2, R * 2};
+            }
+        private:
+            Vector2 _position;
+            uint16_t _size;
+            SDL_Color _color;
+            uint16_t _segment;
         };
 
         class Line {
         public:
             explicit Line() : _start_position(), _end_position(), _size(1), _color(StdColor::Black) {}
             explicit Line(float x1, float y1, float x2, float y2, uint16_t size, const SDL_Color& color)
-                : _start_position(x1, y1), _end_position(x2, y2), _size(size), _color(color) {update();}
+                : _start_position(x1, y1), _end_position(x2, y2), _size(size), _color(color) {}
             explicit Line(const Vector2& start, const Vector2& end, uint16_t size, const SDL_Color &color)
-                : _start_position(start), _end_position(end), _size(size), _color(color) {update();}
+                : _start_position(start), _end_position(end), _size(size), _color(color) {}
 
-            const int *indices() { return _indices.data(); }
-            const SDL_Vertex *vertices() { return _vertices.data(); }
-            [[nodiscard]] size_t indicesCount() const { return _indices.size(); }
+            const int *indices() const { return Algorithm::quadIndices<1>().data(); }
+            const SDL_Vertex *vertices() const { update(); return _vertices.data(); }
+            [[nodiscard]] size_t indicesCount() const { return 6; }
             [[nodiscard]] size_t vertexCount() const { return _vertices.size(); }
             [[nodiscard]] const Vector2& startPosition() const { return _start_position; }
             [[nodiscard]] const Vector2& endPosition() const { return _end_position; }
-            void setStartPosition(const Vector2& pos) { _start_position.reset(pos.x, pos.y); update(); }
-            void setStartPosition(float x, float y) { _start_position.reset(x, y); update(); }
-            void setEndPosition(const Vector2& pos) { _end_position.reset(pos.x, pos.y); update(); }
-            void setEndPosition(float x, float y) { _end_position.reset(x, y); update(); }
+            void setStartPosition(const Vector2& pos) { _start_position.reset(pos.x, pos.y); _dirty |= DirtyFill; }
+            void setStartPosition(float x, float y) { _start_position.reset(x, y); _dirty |= DirtyFill; }
+            void setEndPosition(const Vector2& pos) { _end_position.reset(pos.x, pos.y); _dirty |= DirtyFill; }
+            void setEndPosition(float x, float y) { _end_position.reset(x, y); _dirty |= DirtyFill; }
             [[nodiscard]] uint8_t size() const { return _size; }
-            void setSize(uint8_t new_size) { _size = new_size; update(); }
+            void setSize(uint8_t new_size) { _size = new_size; _dirty |= DirtyFill; }
             [[nodiscard]] const SDL_Color& color() const { return _color; }
-            void setColor(const SDL_Color& color) { _color = color; update(); }
+            void setColor(const SDL_Color& color) { _color = color; _dirty |= DirtyFillColor; }
             void reset(float sx, float sy, float ex, float ey, uint8_t size, const SDL_Color &color) {
                 _start_position.reset(sx, sy);
                 _end_position.reset(ex, ey);
                 _size = size;
                 _color = color;
-                update();
+                _dirty = DirtyAll;
             }
             void reset(const Vector2& start, const Vector2& end, uint8_t size, const SDL_Color& color) {
                 _start_position.reset(start);
                 _end_position.reset(end);
                 _size = size;
                 _color = color;
-                update();
+                _dirty = DirtyAll;
+            }
+            /// Axis-aligned box around everything the shape draws.
+            [[nodiscard]] SDL_FRect bounds() const {
+                const float HALF = std::max(_size / 2.f, 1.f);
+                const float X = std::min(_start_position.x, _end_position.x) - HALF;
+                const float Y = std::min(_start_position.y, _end_position.y) - HALF;
+                return {X, Y, std::abs(_end_position.x - _start_position.x) + HALF * 2,
+                        std::abs(_end_position.y - _start_position.y) + HALF * 2};
             }
         private:
-            void update() {
-                Algorithm::calcLine(_start_position.x, _start_position.y,
-                                          _end_position.x, _end_position.y,
-                                          _size, _color, _vertices, _indices);
+            void update() const {
+                if (_dirty == DirtyNone) return;
+                if (_dirty & DirtyFill) {
+                    /// A line of zero length collapses to a quad that covers nothing.
+                    if (!Algorithm::calcLine(_start_position.x, _start_position.y,
+                                             _end_position.x, _end_position.y,
+                                             _size, _color, _vertices.data())) {
+                        _vertices = {};
+                    }
+                } else {
+                    Algorithm::recolorVertices(_vertices, _color);
+                }
+                _dirty = DirtyNone;
             }
             Vector2 _start_position;
             Vector2 _end_position;
             uint8_t _size;
             SDL_Color _color;
-            std::array<int, 6> _indices;
-            std::array<SDL_Vertex, 4> _vertices;
+            mutable std::array<SDL_Vertex, 4> _vertices{};
+            mutable uint8_t _dirty{DirtyAll};
         };
 
         class Rectangle {
@@ -1382,16 +1426,14 @@ namespace MyEngine {
                                const SDL_Color& background_color = StdColor::White, float degree = 0)
                 : _geometry(geometry), _border_size(border), _border_color(border_color),
                   _background_color(background_color), _rotate(degree) {
-                updateGeometry();
-                updateBorderGeometry();
+                updateBounds();
             }
             explicit Rectangle(float x, float y, float w, float h, uint16_t border = 1,
                                const SDL_Color& border_color = StdColor::Black,
                                const SDL_Color& background_color = StdColor::White, float degree = 0)
                     : _geometry(x, y, w, h), _border_size(border), _border_color(border_color),
                       _background_color(background_color), _rotate(degree) {
-                updateGeometry();
-                updateBorderGeometry();
+                updateBounds();
             }
 
             void reset(float x, float y, float w, float h, uint16_t border = 1,
@@ -1402,8 +1444,8 @@ namespace MyEngine {
                 _border_color = border_color;
                 _background_color = background_color;
                 _rotate = degree;
-                updateGeometry();
-                updateBorderGeometry();
+                _dirty = DirtyAll;
+                updateBounds();
             }
 
             void reset(const GeometryF& geometry, uint16_t border = 1,
@@ -1414,47 +1456,41 @@ namespace MyEngine {
                 _border_color = border_color;
                 _background_color = background_color;
                 _rotate = degree;
-                updateGeometry();
-                updateBorderGeometry();
+                _dirty = DirtyAll;
+                updateBounds();
             }
 
             void move(float x, float y) {
-                _geometry.pos.reset(x, y);
-                updateGeometry();
-                updateBorderGeometry();
+                translate({x, y});
             }
 
             void move(const Vector2& position) {
-                _geometry.pos.reset(position);
-                updateGeometry();
-                updateBorderGeometry();
+                translate(position);
             }
 
             void resize(float w, float h) {
                 _geometry.size.reset(w, h);
-                updateGeometry();
-                updateBorderGeometry();
+                _dirty |= DirtyFill | DirtyBorder;
+                updateBounds();
             }
 
             void resize(const Size& size) {
                 _geometry.size.reset(size);
-                updateGeometry();
-                updateBorderGeometry();
+                _dirty |= DirtyFill | DirtyBorder;
+                updateBounds();
             }
 
             void setBorder(uint16_t border_size, const SDL_Color& color) {
                 _border_size = border_size;
                 _border_color = color;
-                updateBorderGeometry();
+                _dirty |= DirtyBorder;
             }
 
             [[nodiscard]] uint16_t borderSize() const { return _border_size; }
 
             void setBorderColor(const SDL_Color& color) {
                 _border_color = color;
-                for (auto& vertex : _border_vertices) {
-                    vertex.color = Algorithm::convert2FColor(_border_color);
-                }
+                _dirty |= DirtyBorderColor;
             }
 
             [[nodiscard]] const SDL_Color& borderColor() const {
@@ -1463,9 +1499,7 @@ namespace MyEngine {
 
             void setBackgroundColor(const SDL_Color& color) {
                 _background_color = color;
-                for (auto& vertex : _vertices) {
-                    vertex.color = Algorithm::convert2FColor(_background_color);
-                }
+                _dirty |= DirtyFillColor;
             }
 
             [[nodiscard]] const SDL_Color& backgroundColor() const {
@@ -1474,47 +1508,101 @@ namespace MyEngine {
 
             void setRotate(float degree) {
                 _rotate = degree;
-                updateGeometry();
-                updateBorderGeometry();
+                _dirty |= DirtyFill | DirtyBorder;
+                updateBounds();
             }
 
             [[nodiscard]] float rotate() const { return _rotate; }
 
             void setGeometry(float x, float y, float w, float h) {
-                _geometry.reset(x, y, w, h);
-                updateGeometry();
-                updateBorderGeometry();
+                setGeometry(GeometryF(x, y, w, h));
             }
 
             void setGeometry(const GeometryF& geometry) {
+                if (geometry.size.width == _geometry.size.width && geometry.size.height == _geometry.size.height) {
+                    translate(geometry.pos);
+                    return;
+                }
                 _geometry.reset(geometry);
-                updateGeometry();
-                updateBorderGeometry();
+                _dirty |= DirtyFill | DirtyBorder;
+                updateBounds();
             }
 
             [[nodiscard]] const GeometryF& geometry() const { return _geometry; }
 
-            [[nodiscard]] const SDL_Vertex* vertices() const { return _vertices.data(); }
+            [[nodiscard]] const SDL_Vertex* vertices() const { update(); return _vertices.data(); }
             [[nodiscard]] size_t verticesCount() const { return _vertices.size(); }
-            [[nodiscard]] const int* indices() const { return _indices.data(); }
-            [[nodiscard]] size_t indicesCount() const { return _indices.size(); }
-            [[nodiscard]] const SDL_Vertex* borderVertices() const { return _border_vertices.data(); }
+            [[nodiscard]] const int* indices() const { return Algorithm::quadIndices<1>().data(); }
+            [[nodiscard]] size_t indicesCount() const { return 6; }
+            [[nodiscard]] const SDL_Vertex* borderVertices() const { update(); return _border_vertices.data(); }
             [[nodiscard]] size_t borderVerticesCount() const { return _border_vertices.size(); }
-            [[nodiscard]] const int* borderIndices() const { return _border_indices.data(); }
-            [[nodiscard]] size_t borderIndicesCount() const { return _border_indices.size(); }
+            [[nodiscard]] const int* borderIndices() const { return Algorithm::rectangleBorderIndices().data(); }
+            [[nodiscard]] size_t borderIndicesCount() const { return 24; }
+            /// Axis-aligned box around everything the shape draws.
+            [[nodiscard]] const SDL_FRect& bounds() const { return _bounds; }
+
+            /// Brings the vertices of all rectangles up to date. When enough of them need
+            /// new geometry, it is computed for all of them at once with `Algorithm::Batch`.
+            static void updateAll(std::span<Rectangle* const> rects);
         private:
-            void updateGeometry() {
-                if (_background_color.a > 0 ) {
-                    Algorithm::calcFilledRectangleRotated(_geometry, _background_color, _rotate,
-                                                          _vertices, _indices);
-                }
+            /// Fewer shapes than this are not worth gathering for the batch kernels.
+            static constexpr size_t BATCH_MIN = 8;
+
+            /// Applies the pending move to the parts that won't be recomputed anyway.
+            void settleOffset() const {
+                if (_offset.x == 0 && _offset.y == 0) return;
+                if (!(_dirty & DirtyFill)) Algorithm::translateVertices(_vertices, _offset);
+                if (!(_dirty & DirtyBorder)) Algorithm::translateVertices(_border_vertices, _offset);
+                _offset.reset(0, 0);
+            }
+
+            void translate(const Vector2& position) {
+                const Vector2 OFFSET = position - _geometry.pos;
+                _offset += OFFSET;
+                _bounds.x += OFFSET.x;
+                _bounds.y += OFFSET.y;
+                _geometry.pos.reset(position);
             }
 
-            void updateBorderGeometry() {
-                if (_border_size > 0 && _border_color.a > 0) {
-                    Algorithm::calcRectangleRotated(_geometry, _border_color, _border_size, _rotate,
-                                                    _border_vertices, _border_indices);
+            void updateBounds() {
+                const float HW = _geometry.size.width * 0.5f, HH = _geometry.size.height * 0.5f;
+                float ex = HW, ey = HH;
+                if (_rotate != 0) {
+                    const float RAD = _rotate * static_cast<float>(M_PI) / 180.0f;
+                    const float C = std::abs(cosf(RAD)), S = std::abs(sinf(RAD));
+                    ex = HW * C + HH * S;
+                    ey = HW * S + HH * C;
                 }
+                _bounds = {_geometry.pos.x + HW - ex, _geometry.pos.y + HH - ey, ex * 2, ey * 2};
+            }
+
+            void update() const {
+                const bool MOVED = (_offset.x != 0 || _offset.y != 0);
+                if (_dirty == DirtyNone && !MOVED) return;
+                /// Parts that can't be drawn right now stay dirty until they can.
+                if (_dirty & DirtyFill) {
+                    if (_background_color.a > 0) {
+                        Algorithm::calcFilledRectangleRotated(_geometry, _background_color, _rotate,
+                                                              _vertices);
+                        _dirty &= ~(DirtyFill | DirtyFillColor);
+                    }
+                } else {
+                    if (MOVED) Algorithm::translateVertices(_vertices, _offset);
+                    if (_dirty & DirtyFillColor) Algorithm::recolorVertices(_vertices, _background_color);
+                    _dirty &= ~DirtyFillColor;
+                }
+                if (_dirty & DirtyBorder) {
+                    if (_border_size > 0 && _border_color.a > 0) {
+                        Algorithm::calcRectangleRotated(_geometry, _border_color, _border_size, _rotate,
+                                                        _border_vertices);
+                        _dirty &= ~(DirtyBorder | DirtyBorderColor);
+                    }
+                } else {
+                    if (MOVED) Algorithm::translateVertices(_border_vertices, _offset);
+                    if (_dirty & DirtyBorderColor) Algorithm::recolorVertices(_border_vertices, _border_color);
+                    _dirty &= ~DirtyBorderColor;
+                }
+                _offset.reset(0, 0);
             }
 
             GeometryF _geometry;
@@ -1522,10 +1610,11 @@ namespace MyEngine {
             SDL_Color _border_color;
             SDL_Color _background_color;
             float _rotate;
-            std::array<SDL_Vertex, 4> _vertices{};
-            std::array<SDL_Vertex, 8> _border_vertices{};
-            std::array<int, 6> _indices{};
-            std::array<int, 24> _border_indices{};
+            SDL_FRect _bounds{};
+            mutable std::array<SDL_Vertex, 4> _vertices{};
+            mutable std::array<SDL_Vertex, 8> _border_vertices{};
+            mutable Vector2 _offset;
+            mutable uint8_t _dirty{DirtyAll};
         };
 
         class Triangle {
@@ -1536,8 +1625,7 @@ namespace MyEngine {
                               uint16_t border_size = 0, const SDL_Color& border_color = StdColor::Black,
                               const SDL_Color& back_color = StdColor::Black)
                 : _p1(x1, y1), _p2(x2, y2), _p3(x3, y3),
-                  _border_size(border_size), _border_color(border_color), _background_color(back_color)
-                { updateTri(); updateBorder(); }
+                  _border_size(border_size), _border_color(border_color), _background_color(back_color) {}
 
             void reset(float x1, float y1, float x2, float y2, float x3, float y3,
                        uint16_t border_size, const SDL_Color& border_color, const SDL_Color& back_color) {
@@ -1547,8 +1635,7 @@ namespace MyEngine {
                 _border_size = border_size;
                 _border_color = border_color;
                 _background_color = back_color;
-                updateTri();
-                updateBorder();
+                _dirty = DirtyAll;
             }
             void reset(const Vector2& pos1, const Vector2& pos2, const Vector2& pos3,
                        uint16_t border_size, const SDL_Color& border_color, const SDL_Color& back_color) {
@@ -1558,8 +1645,7 @@ namespace MyEngine {
                 _border_size = border_size;
                 _border_color = border_color;
                 _background_color = back_color;
-                updateTri();
-                updateBorder();
+                _dirty = DirtyAll;
             }
             void setPosition(uint8_t index, const Vector2& pos) {
                 switch (index % 3) {
@@ -1573,23 +1659,20 @@ namespace MyEngine {
                         _p3.reset(pos);
                         break;
                 }
-                updateTri();
-                updateBorder();
+                _dirty |= DirtyFill | DirtyBorder;
             }
             void setBorder(uint16_t border_size, const SDL_Color& color) {
                 _border_size = border_size;
                 _border_color = color;
-                updateBorder();
+                _dirty |= DirtyBorder;
             }
             void setBorderColor(const SDL_Color& color) {
                 _border_color = color;
-                updateBorder();
+                _dirty |= DirtyBorderColor;
             }
             void setBackgroundColor(const SDL_Color& color) {
                 _background_color = color;
-                for (auto& vertex : _vertices) {
-                    vertex.color = Algorithm::convert2FColor(color);
-                }
+                _dirty |= DirtyFillColor;
             }
             [[nodiscard]] const Vector2& position(uint8_t index = 0) const {
                 switch (index % 3) {
@@ -1605,29 +1688,55 @@ namespace MyEngine {
             [[nodiscard]] uint16_t borderSize() const { return _border_size; }
             [[nodiscard]] const SDL_Color& borderColor() const { return _border_color; }
             [[nodiscard]] const SDL_Color& backgroundColor() const { return _background_color; }
-            const int *indices() { return _indices.data(); }
-            const SDL_Vertex *vertices() { return _vertices.data(); }
-            const int *borderIndices1() { return _bdi1.data(); }
-            const int *borderIndices2() { return _bdi2.data(); }
-            const int *borderIndices3() { return _bdi3.data(); }
-            const SDL_Vertex *borderVertices1() { return _bd1.data(); }
-            const SDL_Vertex *borderVertices2() { return _bd2.data(); }
-            const SDL_Vertex *borderVertices3() { return _bd3.data(); }
-            [[nodiscard]] size_t borderIndicesCount() const { return _bdi1.size(); }
-            [[nodiscard]] size_t borderVerticesCount() const { return _bd1.size(); }
-            [[nodiscard]] size_t indicesCount() const { return _indices.size(); }
+            const int *indices() const { return Algorithm::triangleIndices().data(); }
+            const SDL_Vertex *vertices() const { update(); return _vertices.data(); }
+            /// The three edges as one quad each: p1-p2, p2-p3, then p1-p3.
+            const int *borderIndices() const { return Algorithm::quadIndices<3>().data(); }
+            const SDL_Vertex *borderVertices() const { update(); return _border_vertices.data(); }
+            [[nodiscard]] size_t borderIndicesCount() const { return 18; }
+            [[nodiscard]] size_t borderVerticesCount() const { return _border_vertices.size(); }
+            [[nodiscard]] size_t indicesCount() const { return 3; }
             [[nodiscard]] size_t vertexCount() const { return _vertices.size(); }
+            /// Axis-aligned box around everything the shape draws.
+            [[nodiscard]] SDL_FRect bounds() const {
+                const float HALF = _border_size / 2.f;
+                const float X = std::min({_p1.x, _p2.x, _p3.x}) - HALF;
+                const float Y = std::min({_p1.y, _p2.y, _p3.y}) - HALF;
+                return {X, Y, std::max({_p1.x, _p2.x, _p3.x}) + HALF - X,
+                        std::max({_p1.y, _p2.y, _p3.y}) + HALF - Y};
+            }
         private:
-            void updateTri() {
-                if (_background_color.a > 0) {
-                    Algorithm::calcTriangle(_p1, _p2, _p3, _background_color, _vertices, _indices);
+            void update() const {
+                if (_dirty == DirtyNone) return;
+                /// Parts that can't be drawn right now stay dirty until they can.
+                if (_dirty & DirtyFill) {
+                    if (_background_color.a > 0) {
+                        Algorithm::calcTriangle(_p1, _p2, _p3, _background_color, _vertices);
+                        _dirty &= ~(DirtyFill | DirtyFillColor);
+                    }
+                } else if (_dirty & DirtyFillColor) {
+                    Algorithm::recolorVertices(_vertices, _background_color);
+                    _dirty &= ~DirtyFillColor;
                 }
-            }
-            void updateBorder() {
-                if (_border_size > 0 && _border_color.a > 0) {
-                    Algorithm::calcLine(_p1.x, _p1.y, _p2.x, _p2.y, _border_size, _border_color, _bd1, _bdi1);
-                    Algorithm::calcLine(_p2.x, _p2.y, _p3.x, _p3.y, _border_size, _border_color, _bd2, _bdi2);
-                    Algorithm::calcLine(_p1.x, _p1.y, _p3.x, _p3.y, _border_size, _border_color, _bd3, _bdi3);
+                if (_dirty & DirtyBorder) {
+                    if (_border_size > 0 && _border_color.a > 0) {
+                        const std::array<std::pair<const Vector2*, const Vector2*>, 3> EDGES = {{
+                            {&_p1, &_p2}, {&_p2, &_p3}, {&_p1, &_p3}
+                        }};
+                        for (size_t i = 0; i < EDGES.size(); ++i) {
+                            auto [from, to] = EDGES[i];
+                            SDL_Vertex* quad = _border_vertices.data() + i * 4;
+                            /// An edge of zero length collapses to a quad that covers nothing.
+                            if (!Algorithm::calcLine(from->x, from->y, to->x, to->y, _border_size,
+                                                     _border_color, quad)) {
+                                std::fill_n(quad, 4, SDL_Vertex{});
+                            }
+                        }
+                        _dirty &= ~(DirtyBorder | DirtyBorderColor);
+                    }
+                } else if (_dirty & DirtyBorderColor) {
+                    Algorithm::recolorVertices(_border_vertices, _border_color);
+                    _dirty &= ~DirtyBorderColor;
                 }
             }
             Vector2 _p1;
@@ -1636,36 +1745,33 @@ namespace MyEngine {
             uint16_t _border_size;
             SDL_Color _border_color;
             SDL_Color _background_color;
-            std::array<SDL_Vertex, 3> _vertices;
-            std::array<int, 3> _indices;
-            std::array<SDL_Vertex, 4> _bd1;
-            std::array<SDL_Vertex, 4> _bd2;
-            std::array<SDL_Vertex, 4> _bd3;
-            std::array<int, 6> _bdi1;
-            std::array<int, 6> _bdi2;
-            std::array<int, 6> _bdi3;
+            mutable std::array<SDL_Vertex, 3> _vertices{};
+            mutable std::array<SDL_Vertex, 12> _border_vertices{};
+            mutable uint8_t _dirty{DirtyAll};
         };
 
+        /// Its vertices are not stored but generated whenever they are requested, and the
+        /// indices are shared by all ellipses with the same segment count.
         class Ellipse {
         public:
             explicit Ellipse() : _center_point(0, 0), _radius(0, 0),
                                  _border_size(0), _border_color(StdColor::Black), _background_color(StdColor::Transparent),
                                  _degree(0.f), _count(0) {}
 
+            /// A `segment` of 0 picks the count from the radius, see `Algorithm::adaptiveSegment`.
             Ellipse(float cx, float cy, float rw, float rh, uint16_t border_size = 1,
                     const SDL_Color& border_color = StdColor::Black,
                     const SDL_Color& back_color = StdColor::Black,
-                    float degree = 0.f, uint16_t segment = 32)
+                    float degree = 0.f, uint16_t segment = 0)
                     : _center_point(cx, cy), _radius(rw, rh), _border_size(border_size),
                       _border_color(border_color), _background_color(back_color),
                       _degree(degree), _count(segment) {
-                updateFilledEllipse();
-                updateEllipse();
+                updateBounds();
             }
 
             void reset(float cx, float cy, float rw, float rh, uint16_t border_size,
                        const SDL_Color& border_color, const SDL_Color& back_color, float degree,
-                       uint16_t segment = 32) {
+                       uint16_t segment = 0) {
                 _center_point.reset(cx, cy);
                 _radius.reset(rw, rh);
                 _border_size = border_size;
@@ -1673,13 +1779,12 @@ namespace MyEngine {
                 _background_color = back_color;
                 _degree = degree;
                 _count = segment;
-                updateFilledEllipse();
-                updateEllipse();
+                updateBounds();
             }
 
             void reset(const Vector2& center_pos, const Size& radius, uint16_t border_size,
                        const SDL_Color& border_color, const SDL_Color& back_color, float degree,
-                       uint16_t segment = 32) {
+                       uint16_t segment = 0) {
                 _center_point.reset(center_pos);
                 _radius.reset(radius);
                 _border_size = border_size;
@@ -1687,48 +1792,45 @@ namespace MyEngine {
                 _background_color = back_color;
                 _degree = degree;
                 _count = segment;
-                updateFilledEllipse();
-                updateEllipse();
+                updateBounds();
+            }
+
+            void move(float x, float y) {
+                move({x, y});
+            }
+
+            void move(const Vector2& position) {
+                _bounds.x += position.x - _center_point.x;
+                _bounds.y += position.y - _center_point.y;
+                _center_point.reset(position);
             }
 
             void setGeometry(float x, float y, float rw, float rh) {
-                _center_point.reset(x, y);
-                _radius.reset(rw, rh);
-                updateFilledEllipse();
-                updateEllipse();
+                setGeometry(Vector2(x, y), Size(rw, rh));
             }
 
             void setGeometry(const Vector2& position, const Size& size) {
                 _center_point.reset(position);
                 _radius.reset(size);
-                updateFilledEllipse();
-                updateEllipse();
+                updateBounds();
             }
 
             void setBorder(uint16_t size, const SDL_Color& color) {
                 _border_size = size;
                 _border_color = color;
-                updateEllipse();
             }
 
             void setBorderColor(const SDL_Color& color) {
                 _border_color = color;
-                for (auto& vertex : _border_vertices) {
-                    vertex.color = Algorithm::convert2FColor(color);
-                }
             }
 
             void setBackground(const SDL_Color& color) {
                 _background_color = color;
-                for (auto& vertex : _vertices) {
-                    vertex.color = Algorithm::convert2FColor(color);
-                }
             }
 
             void setRotate(float rotate) {
                 _degree = rotate;
-                updateFilledEllipse();
-                updateEllipse();
+                updateBounds();
             }
 
             [[nodiscard]] const Vector2& centerPosition() const { return _center_point; }
@@ -1737,39 +1839,102 @@ namespace MyEngine {
             [[nodiscard]] const SDL_Color& borderColor() const { return _border_color; }
             [[nodiscard]] const SDL_Color& backgroundColor() const { return _background_color; }
             [[nodiscard]] float rotateDegree() const { return _degree; }
-            [[nodiscard]] const int *indices() const { return _indices.data(); }
-            [[nodiscard]] const SDL_Vertex *vertices() const { return _vertices.data(); }
-            [[nodiscard]] size_t indicesCount() const { return _indices.size(); }
-            [[nodiscard]] size_t vertexCount() const { return _vertices.size(); }
-            [[nodiscard]] const int *borderIndices() const { return _border_indices.data(); }
-            [[nodiscard]] const SDL_Vertex *borderVertices() const { return _border_vertices.data(); }
-            [[nodiscard]] size_t borderIndicesCount() const { return _border_indices.size(); }
-            [[nodiscard]] size_t borderVerticesCount() const { return _border_vertices.size(); }
+
+            void setSegment(uint16_t segment = 0) {
+                _count = segment;
+            }
+
+            /// The segment count the geometry is generated with.
+            [[nodiscard]] uint16_t segment() const {
+                return _count ? _count : Algorithm::adaptiveSegment(std::max(_radius.width, _radius.height));
+            }
+            /// Whether the border leaves room for the inner edge of the ring.
+            [[nodiscard]] bool hasBorder() const {
+                return _border_size > 0 && _border_color.a > 0 &&
+                       _radius.width > _border_size && _radius.height > _border_size;
+            }
+            /// Write `vertexCount()` and `borderVerticesCount()` vertices to `out`.
+            void fillVertices(SDL_Vertex* out) const {
+                Algorithm::calcEllipse(_center_point, _radius, _background_color, _degree, segment(), out);
+            }
+            void fillBorderVertices(SDL_Vertex* out) const {
+                Algorithm::calcEllipseRing(_center_point, _radius, _border_size, _border_color, _degree,
+                                           segment(), out);
+            }
+            /// Generated into buffers of the calling thread, valid until the next call of the
+            /// same function.
+            [[nodiscard]] const SDL_Vertex *vertices() const {
+                thread_local std::vector<SDL_Vertex> scratch;
+                scratch.resize(vertexCount());
+                fillVertices(scratch.data());
+                return scratch.data();
+            }
+            [[nodiscard]] const SDL_Vertex *borderVertices() const {
+                thread_local std::vector<SDL_Vertex> scratch;
+                scratch.resize(borderVerticesCount());
+                if (!scratch.empty()) fillBorderVertices(scratch.data());
+                return scratch.data();
+            }
+            [[nodiscard]] const int *indices() const {
+                return Algorithm::sharedIndices(Algorithm::Topology::Fan, segment()).data();
+            }
+            [[nodiscard]] const int *borderIndices() const {
+                return Algorithm::sharedIndices(Algorithm::Topology::Ring, segment()).data();
+            }
+            [[nodiscard]] size_t vertexCount() const { return segment() + 2; }
+            [[nodiscard]] size_t indicesCount() const { return segment() * 3; }
+            [[nodiscard]] size_t borderVerticesCount() const { return hasBorder() ? (segment() + 1) * 2 : 0; }
+            [[nodiscard]] size_t borderIndicesCount() const { return hasBorder() ? segment() * 6 : 0; }
+            /// Axis-aligned box around everything the shape draws.
+            [[nodiscard]] const SDL_FRect& bounds() const { return _bounds; }
+
+            /// Appends the geometry of all ellipses to `vertices` and `indices`, each ellipse's
+            /// fill before its border. Ellipses with the same segment count are generated
+            /// together with `Algorithm::Batch` once there are enough of them.
+            static void tessellateAll(std::span<Ellipse* const> ellipses, std::vector<SDL_Vertex>& vertices,
+                                      std::vector<int>& indices);
 
         private:
-            void updateFilledEllipse() {
-                if (_background_color.a > 0) {
-                    Algorithm::calcEllipse(_center_point, _radius,
-                                                     _background_color, _degree, _count,
-                                                     _vertices, _indices);
+            /// Fewer shapes than this are not worth gathering for the batch kernels.
+            static constexpr size_t BATCH_MIN = 8;
+
+            /// The fill or border of one ellipse and where its vertices go.
+            struct Part {
+                const Ellipse* ellipse;
+                size_t offset;
+                uint16_t segment;
+                bool ring;
+            };
+
+            static void appendIndices(std::vector<SDL_Vertex>& vertices, std::vector<int>& indices,
+                                      Algorithm::Topology topology, uint16_t segment, size_t vertex_count) {
+                const int BASE = static_cast<int>(vertices.size());
+                for (int index : Algorithm::sharedIndices(topology, segment)) {
+                    indices.push_back(BASE + index);
                 }
+                vertices.resize(vertices.size() + vertex_count);
             }
-            void updateEllipse() {
-                if (_border_size > 0 && _border_color.a > 0) {
-                    Algorithm::calcEllipseRing(_center_point, _radius, _border_size,
-                                                         _border_color, _degree, _count,
-                                                         _border_vertices, _border_indices);
-                }
+
+            /// Generates parts that all have the same segment count and kind.
+            static void batchFill(std::span<const Part> parts, std::vector<SDL_Vertex>& vertices);
+
+            void updateBounds() {
+                const float RAD = _degree * static_cast<float>(M_PI) / 180.f;
+                const float C = cosf(RAD), S = sinf(RAD);
+                const float RW = _radius.width, RH = _radius.height;
+                const float EX = std::sqrt(RW * RW * C * C + RH * RH * S * S);
+                const float EY = std::sqrt(RW * RW * S * S + RH * RH * C * C);
+                _bounds = {_center_point.x - EX, _center_point.y - EY, EX * 2, EY * 2};
             }
+
             Vector2 _center_point;
             Size _radius;
             uint16_t _border_size;
             SDL_Color _border_color;
             SDL_Color _background_color;
             float _degree;
-            uint16_t _count{32};
-            std::vector<SDL_Vertex> _vertices, _border_vertices;
-            std::vector<int> _indices, _border_indices;
+            uint16_t _count{0};
+            SDL_FRect _bounds{};
         };
     }
 }
@@ -87,6 +87,16 @@ namespace MyEngine {
         return _font_kerning;
     }
 
+    void Font::setSDF(bool enabled) {
+        if (TTF_SetFontSDF(_font, enabled)) {
+            _sdf = enabled;
+        }
+    }
+
+    bool Font::isSDF() const {
+        return _sdf;
+    }
+
     void Font::setLineSpacing(uint32_t spacing) {
         TTF_SetFontLineSkip(_font, spacing);
         _line_spacing = spacing;
@@ -176,56 +186,226 @@ namespace MyEngine {
         return _font;
     }
 
-    FontMap FontDatabase::getFontDatabaseFromSystem() {
-        if (!_is_loaded) {
-            StringList find_font_dir;
+    static std::string homeDirectory() {
 #ifdef _WIN32
-            find_font_dir.emplace_back("C:/Windows/Fonts");
+        auto home = std::getenv("USERPROFILE");
+#else
+        auto home = std::getenv("HOME");
+#endif
+        return home ? home : "";
+    }
+
+    StringList FontDatabase::fontDirectories() {
+        StringList find_font_dir;
+        const std::string HOME = homeDirectory();
+        auto add_dir = [&find_font_dir](const std::string& dir) {
+            if (FileSystem::isDir(dir)) find_font_dir.emplace_back(dir);
+        };
+#ifdef _WIN32
+        find_font_dir.emplace_back("C:/Windows/Fonts");
 #endif
 #ifdef __linux__
-            find_font_dir.emplace_back("/usr/share/fonts");
-            if (FileSystem::isDir("~/.fonts")) {
-                find_font_dir.emplace_back("~/.fonts");
-            }
-            if (FileSystem::isDir("~/.local/share/fonts")) {
-                find_font_dir.emplace_back("~/.local/share/fonts");
-            }
+        find_font_dir.emplace_back("/usr/share/fonts");
+        if (!HOME.empty()) {
+            add_dir(HOME + "/.fonts");
+            add_dir(HOME + "/.local/share/fonts");
+        }
 #endif
 #ifdef __APPLE__
-            if (FileSystem::isDir("/System/Library/Fonts")) {
-                find_font_dir.emplace_back("/System/Library/Fonts");
+        add_dir("/System/Library/Fonts");
+        add_dir("/Library/Fonts");
+        if (!HOME.empty()) add_dir(HOME + "/Library/Fonts");
+#endif
+        return find_font_dir;
+    }
+
+    static int64_t modifiedTime(const std::filesystem::path& path) {
+        std::error_code error;
+        auto time = std::filesystem::last_write_time(path, error);
+        return error ? -1 : static_cast<int64_t>(time.time_since_epoch().count());
+    }
+
+    FontDatabase::Index FontDatabase::scan(const StringList& roots, const std::stop_token& token) {
+        static const StringList FONT_EXTENSIONS = {".ttf", ".otf", ".ttc", ".woff", ".eot"};
+        Index index;
+        index.roots = roots;
+        for (auto& font_dir : roots) {
+            index.directories.emplace_back(font_dir, modifiedTime(font_dir));
+            std::error_code error;
+            std::filesystem::recursive_directory_iterator it(font_dir,
+                    std::filesystem::directory_options::skip_permission_denied, error);
+            for (; !error && it != std::filesystem::recursive_directory_iterator(); it.increment(error)) {
+                if (token.stop_requested()) return index;
+                const auto& PATH = it->path();
+                if (it->is_directory(error)) {
+                    index.directories.emplace_back(PATH.string(), modifiedTime(PATH));
+                    continue;
+                }
+                const auto EXT = PATH.extension().string();
+                if (std::find(FONT_EXTENSIONS.begin(), FONT_EXTENSIONS.end(), EXT) == FONT_EXTENSIONS.end()) continue;
+                /// The first font found under a name wins, as it always did.
+                index.fonts.try_emplace(PATH.stem().string(), PATH.string());
+            }
+        }
+        return index;
+    }
+
+    bool FontDatabase::upToDate(const Index& index) {
+        for (auto& [dir, time] : index.directories) {
+            if (modifiedTime(dir) != time) return false;
+        }
+        return true;
+    }
+
+    void FontDatabase::refresh(const std::stop_token& token, Index cached) {
+        if (upToDate(cached)) return;
+        auto index = scan(cached.roots, token);
+        if (token.stop_requested()) return;
+        writeCache(index);
+        std::lock_guard lock(_mutex);
+        _font_db = std::move(index.fonts);
+        Logger::log("FontDatabase: Font index refreshed from system!", Logger::Debug);
+    }
+
+    /// "MEFI", then the version.
+    static constexpr uint32_t FONT_INDEX_MAGIC = 0x4946454D, FONT_INDEX_VERSION = 1;
+    static constexpr uint32_t MAX_FONT_INDEX_STRING = 4096;
+
+    bool FontDatabase::readCache(Index& index) {
+        std::ifstream file(cachePath(), std::ios::binary);
+        if (!file.is_open()) return false;
+        auto read_u32 = [&file] {
+            uint32_t value = 0;
+            file.read(reinterpret_cast<char*>(&value), sizeof(value));
+            return value;
+        };
+        auto read_string = [&file, &read_u32] {
+            const uint32_t SIZE = read_u32();
+            /// A damaged file must not turn into a huge allocation.
+            if (!file || SIZE > MAX_FONT_INDEX_STRING) {
+                file.setstate(std::ios::failbit);
+                return std::string();
+            }
+            std::string value(SIZE, '\0');
+            file.read(value.data(), static_cast<std::streamsize>(SIZE));
+            return value;
+        };
+        if (read_u32() != FONT_INDEX_MAGIC || read_u32() != FONT_INDEX_VERSION) return false;
+        const uint32_t ROOT_COUNT = read_u32();
+        for (uint32_t i = 0; i < ROOT_COUNT && file; ++i) {
+            index.roots.push_back(read_string());
+        }
+        const uint32_t DIR_COUNT = read_u32();
+        for (uint32_t i = 0; i < DIR_COUNT && file; ++i) {
+            auto dir = read_string();
+            int64_t time = 0;
+            file.read(reinterpret_cast<char*>(&time), sizeof(time));
+            index.directories.emplace_back(std::move(dir), time);
+        }
+        const uint32_t FONT_COUNT = read_u32();
+        for (uint32_t i = 0; i < FONT_COUNT && file; ++i) {
+            auto name = read_string();
+            index.fonts.try_emplace(std::move(name), read_string());
+        }
+        return static_cast<bool>(file);
+    }
+
+    bool FontDatabase::writeCache(const Index& index) {
+        const std::filesystem::path PATH = cachePath();
+        std::error_code error;
+        std::filesystem::create_directories(PATH.parent_path(), error);
+        /// Written next to the cache and renamed over it, so a reader never sees half a file.
+        auto temp_path = PATH;
+        temp_path += ".tmp";
+        {
+            std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+            if (!file.is_open()) {
+                Logger::log(std::format("FontDatabase: Can't write font index '{}'!", temp_path.string()), Logger::Warn);
+                return false;
             }
-            if (FileSystem::isDir("/Library/Fonts")) {
-                find_font_dir.emplace_back("/Library/Fonts");
+            auto write_u32 = [&file](uint32_t value) {
+                file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+            };
+            auto write_string = [&file, &write_u32](const std::string& value) {
+                write_u32(static_cast<uint32_t>(value.size()));
+                file.write(value.data(), static_cast<std::streamsize>(value.size()));
+            };
+            write_u32(FONT_INDEX_MAGIC);
+            write_u32(FONT_INDEX_VERSION);
+            write_u32(static_cast<uint32_t>(index.roots.size()));
+            for (auto& root : index.roots) write_string(root);
+            write_u32(static_cast<uint32_t>(index.directories.size()));
+            for (auto& [dir, time] : index.directories) {
+                write_string(dir);
+                file.write(reinterpret_cast<const char*>(&time), sizeof(time));
             }
-            if (FileSystem::isDir("~/Library/Fonts")) {
-                find_font_dir.emplace_back("~/Library/Fonts");
+            write_u32(static_cast<uint32_t>(index.fonts.size()));
+            for (auto& [name, path] : index.fonts) {
+                write_string(name);
+                write_string(path);
             }
+            if (!file) return false;
+        }
+        std::filesystem::rename(temp_path, PATH, error);
+        return !error;
+    }
+
+    void FontDatabase::setCachePath(const std::string& path) {
+        std::lock_guard lock(_mutex);
+        _cache_path = path;
+    }
+
+    std::string FontDatabase::cachePath() {
+        if (!_cache_path.empty()) return _cache_path;
+        std::filesystem::path dir;
+#ifdef _WIN32
+        if (auto local = std::getenv("LOCALAPPDATA")) dir = local;
+#elif defined(__APPLE__)
+        if (!homeDirectory().empty()) dir = homeDirectory() + "/Library/Caches";
+#else
+        if (auto xdg = std::getenv("XDG_CACHE_HOME"); xdg && *xdg) dir = xdg;
+        else if (!homeDirectory().empty()) dir = homeDirectory() + "/.cache";
 #endif
-            for (auto& font_dir : find_font_dir) {
-                StringList font_files = FileSystem::listFilesRecursively(font_dir,
-                                                                         {".ttf", ".otf", ".ttc", ".woff", ".eot"});
-                for (auto& file : font_files) {
-                    auto short_file = FileSystem::getShortFileName(file, true);
-                    if (!_font_db.contains(short_file)) {
-                        _font_db.insert({FileSystem::getShortFileName(file, true), file});
-                    }
-                }
+        if (dir.empty()) {
+            std::error_code error;
+            dir = std::filesystem::temp_directory_path(error);
+        }
+        return (dir / "MyEngine" / "fonts.idx").string();
+    }
+
+    void FontDatabase::waitForRefresh() {
+        if (_refresh.joinable()) _refresh.join();
+    }
+
+    FontMap FontDatabase::getFontDatabaseFromSystem() {
+        std::lock_guard lock(_mutex);
+        if (!_is_loaded.load(std::memory_order_relaxed)) {
+            const auto ROOTS = fontDirectories();
+            Index index;
+            if (readCache(index) && index.roots == ROOTS) {
+                _font_db = index.fonts;
+                _refresh = std::jthread(refresh, std::move(index));
+                Logger::log("FontDatabase: Get Font files from index cache!", Logger::Debug);
+            } else {
+                index = scan(ROOTS, {});
+                writeCache(index);
+                _font_db = std::move(index.fonts);
+                Logger::log("FontDatabase: Get Font files from system!", Logger::Debug);
             }
-            Logger::log("FontDatabase: Get Font files from system!", Logger::Debug);
-            _is_loaded = true;
+            _is_loaded.store(true, std::memory_order_release);
         }
         return _font_db;
     }
 
     std::string FontDatabase::findFontFromSystem(const std::string &font_name) {
-        if (!_is_loaded) getFontDatabaseFromSystem();
-        if (!_font_db.contains(font_name)) return {};
-        return _font_db[font_name];
+        if (!_is_loaded.load(std::memory_order_acquire)) getFontDatabaseFromSystem();
+        std::lock_guard lock(_mutex);
+        auto it = _font_db.find(font_name);
+        return it == _font_db.end() ? std::string() : it->second;
     }
 
     std::vector<FontDatabase::FontInfo> FontDatabase::getSystemDefaultFont() {
-        if (!_is_loaded) getFontDatabaseFromSystem();
+        if (!_is_loaded.load(std::memory_order_acquire)) getFontDatabaseFromSystem();
         std::vector<FontDatabase::FontInfo> default_fonts;
 #ifdef _WIN32
         StringList common_fonts = { "arial", "segoeui", "tahoma", "verdana", "calibri" };
@@ -256,6 +436,7 @@ namespace MyEngine {
         if (!_surface) {
             Logger::log(std::format("Texture: The image path '{}' is not found!", path), Logger::Error);
             _property = std::make_unique<TextureProperty>();
+            _status = Failed;
             return;
         }
         _texture = SDL_CreateTextureFromSurface(_renderer->self(), _surface);
@@ -302,7 +483,14 @@ namespace MyEngine {
         Logger::log(std::format("Texture: Size set to {}x{}", width, height), Logger::Debug);
     }
 
+    Texture::Texture(const std::string &path, Renderer *renderer, LoadCallback on_loaded)
+        : _surface(nullptr), _texture(nullptr), _renderer(renderer) {
+        _property = std::make_unique<TextureProperty>();
+        setImagePathAsync(path, std::move(on_loaded));
+    }
+
     Texture::~Texture() {
+        cancelLoad();
         if (_texture) {
             SDL_DestroyTexture(_texture);
         }
@@ -316,6 +504,7 @@ namespace MyEngine {
     }
 
     bool Texture::setImagePath(const std::string& path) {
+        cancelLoad();
         auto img = IMG_Load(path.c_str());
         _path = path;
         if (!img) {
@@ -331,16 +520,70 @@ namespace MyEngine {
         _surface = img;
         _texture = SDL_CreateTextureFromSurface(_renderer->self(), _surface);
         _property->resize(_surface->w, _surface->h);
+        _status = Ready;
         Logger::log(std::format("Texture image changed to '{}'", path), Logger::Debug);
         Logger::log(std::format("Texture size updated to {}x{}", _surface->w, _surface->h), Logger::Debug);
         return true;
     }
 
+    bool Texture::setImagePathAsync(const std::string& path, LoadCallback on_loaded) {
+        if (!_renderer) {
+            Logger::log("Texture: Can't load image! The renderer is not valid!", Logger::Error);
+            return false;
+        }
+        cancelLoad();
+        _path = path;
+        _status = Pending;
+        _on_loaded = std::move(on_loaded);
+        _load_id = _renderer->textureLoader().load(path, [this](SDL_Surface* surface) {
+            finishLoad(surface);
+        });
+        return true;
+    }
+
+    void Texture::cancelLoad() {
+        if (_status != Pending) return;
+        _renderer->textureLoader().cancel(_load_id);
+        _load_id = 0;
+        _on_loaded = {};
+        _status = _texture ? Ready : Failed;
+    }
+
+    void Texture::finishLoad(SDL_Surface* surface) {
+        _load_id = 0;
+        auto on_loaded = std::move(_on_loaded);
+        _on_loaded = {};
+        SDL_Texture* texture = surface ? SDL_CreateTextureFromSurface(_renderer->self(), surface) : nullptr;
+        if (!texture) {
+            if (surface) {
+                Logger::log(std::format("Texture: Created texture failed!\nException: {}", SDL_GetError()), Logger::Error);
+                SDL_DestroySurface(surface);
+            }
+            _status = Failed;
+            if (on_loaded) on_loaded(this, false);
+            return;
+        }
+        /// A recorded frame may still draw the old texture.
+        _renderer->releaseTexture(_texture);
+        if (_surface) SDL_DestroySurface(_surface);
+        _surface = surface;
+        _texture = texture;
+        _property->resize(_surface->w, _surface->h);
+        _status = Ready;
+        Logger::log(std::format("Texture: Loaded image path '{}'", _path), Logger::Debug);
+        if (on_loaded) on_loaded(this, true);
+    }
+
+    Texture::Status Texture::status() const {
+        return _status;
+    }
+
     const std::string& Texture::imagePath() const {
         return _path;
     }
 
     bool Texture::setImageFromSurface(SDL_Surface *surface, bool deep_copy) {
+        cancelLoad();
         if (!surface) {
             Logger::log(std::format("The surface is not valid!\nException: {}", SDL_GetError()), Logger::Error);
             _property = std::make_unique<TextureProperty>();
@@ -353,13 +596,14 @@ namespace MyEngine {
         _property->clip_mode = false;
         _property->color_alpha = RGBAColor::White;
         _property->setScale(1.0f);
+        _status = Ready;
         Logger::log(std::format("Texture created from surface"), Logger::Debug);
         Logger::log(std::format("Texture size set to {}x{}", _surface->w, _surface->h), Logger::Debug);
         return true;
     }
 
     SDL_Texture* Texture::self() const {
-        if (!_texture) {
+        if (!_texture && _status != Pending) {
             Logger::log("Texture: The current texture is not created or not valid!", Logger::Error);
         }
         return _texture;
@@ -375,6 +619,7 @@ namespace MyEngine {
 
     void Texture::draw() {
         if (!_texture) {
+            if (_status == Pending) return;
             Logger::log("The texture is not created!", Logger::Error);
             return;
         }
@@ -627,6 +872,120 @@ namespace MyEngine {
         _start_time = 0;
     }
 
+    RenderLayer::RenderLayer(Renderer *renderer, int width, int height)
+        : _renderer(renderer), _width(width), _height(height) {
+        if (!_renderer) {
+            Logger::log("RenderLayer: The specified renderer can not be null!", Logger::Fatal);
+            Engine::throwFatalError();
+        }
+    }
+
+    RenderLayer::~RenderLayer() = default;
+
+    Renderer *RenderLayer::render() const {
+        return _renderer;
+    }
+
+    void RenderLayer::begin() {
+        _renderer->beginRecord(&_list);
+    }
+
+    void RenderLayer::end() {
+        _renderer->endRecord();
+        _needs_render = true;
+    }
+
+    void RenderLayer::markDirty() {
+        _list.markDirty();
+    }
+
+    bool RenderLayer::dirty() const {
+        return _list.dirty();
+    }
+
+    void RenderLayer::resize(int width, int height) {
+        _width = width;
+        _height = height;
+    }
+
+    Size RenderLayer::size() const {
+        if (!_texture) return Size(static_cast<float>(_width), static_cast<float>(_height));
+        return _texture->property()->size();
+    }
+
+    void RenderLayer::setPosition(const Vector2 &position) {
+        _position = position;
+    }
+
+    const Vector2 &RenderLayer::position() const {
+        return _position;
+    }
+
+    Texture *RenderLayer::texture() const {
+        return _texture.get();
+    }
+
+    void RenderLayer::draw() {
+        /// The target texture is created when the layer is composited, on the thread
+        /// that renders the frame.
+        _renderer->drawLayer(this);
+    }
+
+    bool RenderLayer::updateTexture() {
+        int width = _width, height = _height;
+        if (width <= 0 || height <= 0) {
+            if (!SDL_GetCurrentRenderOutputSize(_renderer->self(), &width, &height)) {
+                Logger::log(std::format("RenderLayer: Get render output size failed! Exception: {}",
+                                        SDL_GetError()), Logger::Error);
+                return false;
+            }
+        }
+        if (width <= 0 || height <= 0) return false;
+        if (_texture && _texture->isValid()) {
+            auto tex = _texture->self();
+            if (tex->w == width && tex->h == height) return true;
+        }
+        _texture = std::make_unique<Texture>(_renderer, SDL_PIXELFORMAT_RGBA8888, width, height,
+                                             SDL_TEXTUREACCESS_TARGET);
+        if (!_texture->isValid()) return false;
+        /// Drawing with BLEND into a target cleared to transparent leaves premultiplied
+        /// colors in it; compositing those with BLEND would apply alpha a second time.
+        SDL_SetTextureBlendMode(_texture->self(), SDL_BLENDMODE_BLEND_PREMULTIPLIED);
+        _needs_render = true;
+        Logger::log(std::format("RenderLayer: Target texture resized to {}x{}", width, height), Logger::Debug);
+        return true;
+    }
+
+    void RenderLayer::composite(const RenderCommand::RenderContext &context) {
+        static constexpr int QUAD_INDICES[6] = { 0, 1, 2, 0, 2, 3 };
+        if (!updateTexture()) return;
+        auto target = _texture->self();
+        if (_needs_render) {
+            context.flushGeometry();
+            auto previous = SDL_GetRenderTarget(context.renderer);
+            if (!SDL_SetRenderTarget(context.renderer, target)) {
+                Logger::log(std::format("RenderLayer: Set render target failed! Exception: {}",
+                                        SDL_GetError()), Logger::Error);
+                return;
+            }
+            /// Viewport and clip rect belong to the target, so nothing cached is valid here.
+            if (context.state) context.state->invalidate();
+            context.setDrawColor({0, 0, 0, 0});
+            SDL_RenderClear(context.renderer);
+            _list.replay(context);
+            context.flushGeometry();
+            SDL_SetRenderTarget(context.renderer, previous);
+            if (context.state) context.state->invalidate();
+            _needs_render = false;
+        }
+        const float X = _position.x, Y = _position.y;
+        const float W = static_cast<float>(target->w), H = static_cast<float>(target->h);
+        const SDL_FColor COLOR = {1.f, 1.f, 1.f, 1.f};
+        const SDL_Vertex QUAD[4] = {{{X, Y}, COLOR, {0.f, 0.f}}, {{X + W, Y}, COLOR, {1.f, 0.f}},
+                                    {{X + W, Y + H}, COLOR, {1.f, 1.f}}, {{X, Y + H}, COLOR, {0.f, 1.f}}};
+        context.renderGeometry(QUAD, 4, QUAD_INDICES, 6, target);
+    }
+
     BGM::BGM(MIX_Mixer *mixer, const std::string &path) : _mixer(mixer), _path(path) {
         if (!_mixer) {
             Logger::log("BGM: The specified mixer can not be null!", Logger::Fatal);
@@ -3,6 +3,7 @@
 #define MYENGINE_COMPONETS_H
 #include "Basic.h"
 #include "MultiThread/Components.h"
+#include "Renderer/RenderList.h"
 
 namespace MyEngine {
     class Font {
@@ -50,6 +51,10 @@ namespace MyEngine {
         bool fontKerning() const;
         void setLineSpacing(uint32_t spacing);
         uint32_t lineSpacing() const;
+        /// Render glyphs as signed distance fields. They are meant to be drawn through the
+        /// renderer's glyph atlas, which scales them to any size from a single rasterization.
+        void setSDF(bool enabled);
+        bool isSDF() const;
         SDL_Surface* toImage(const std::string& text);
         SDL_Surface* toImage(const std::string& text, const SDL_Color& backgrond_color);
 
@@ -65,6 +70,7 @@ namespace MyEngine {
         uint32_t _font_hinting{};
         bool _font_kerning{};
         uint32_t _line_spacing{};
+        bool _sdf{false};
         bool _font_is_loaded{false};
     };
 
@@ -82,12 +88,38 @@ namespace MyEngine {
             std::string font_path;
         };
 
+        /// The first call loads the font index cached by an earlier run and checks it
+        /// against the font directories on a background thread, so only the very first
+        /// run has to scan them before returning.
         static FontMap getFontDatabaseFromSystem();
         static std::string findFontFromSystem(const std::string &font_name);
         static std::vector<FontInfo> getSystemDefaultFont();
+        /// Where the font index is kept between runs. Must be set before the first lookup.
+        static void setCachePath(const std::string& path);
+        static std::string cachePath();
+        /// Blocks until the background check of the cached index is done.
+        static void waitForRefresh();
     private:
-        static bool _is_loaded;
+        /// Fonts by short file name, plus the modification time of every directory they
+        /// were found in. Adding or removing a font changes the time of its directory.
+        struct Index {
+            StringList roots;
+            std::vector<std::pair<std::string, int64_t>> directories;
+            FontMap fonts;
+        };
+        static StringList fontDirectories();
+        static Index scan(const StringList& roots, const std::stop_token& token);
+        static bool upToDate(const Index& index);
+        static void refresh(const std::stop_token& token, Index cached);
+        static bool readCache(Index& index);
+        static bool writeCache(const Index& index);
+
+        /// Set under `_mutex`, but also checked without it before taking the lock.
+        static std::atomic<bool> _is_loaded;
         static FontMap _font_db;
+        static std::mutex _mutex;
+        static std::string _cache_path;
+        static std::jthread _refresh;
     };
 
     class BGM {
@@ -343,6 +375,16 @@ namespace MyEngine {
         [[nodiscard]] const Vector2& scaledAnchor() const {
             return _scaled_anchor;
         }
+        /// Screen area the texture may cover, with room for any rotation around the anchor.
+        [[nodiscard]] SDL_FRect bounds() const {
+            if (rotate_angle == 0.0) {
+                return {_scaled_position.x, _scaled_position.y, _scaled_size.width, _scaled_size.height};
+            }
+            const float FX = std::max(std::abs(_scaled_anchor.x), std::abs(_scaled_size.width - _scaled_anchor.x));
+            const float FY = std::max(std::abs(_scaled_anchor.y), std::abs(_scaled_size.height - _scaled_anchor.y));
+            const float R = std::sqrt(FX * FX + FY * FY);
+            return {_scaled_position.x + _scaled_anchor.x - R, _scaled_position.y + _scaled_anchor.y - R, R * 2, R * 2};
+        }
     private:
         Vector2 _position;
         Size _size;
@@ -361,12 +403,29 @@ namespace MyEngine {
         Texture &operator=(Texture &&) = delete;
         explicit Texture(const std::string &path, Renderer *renderer);
         explicit Texture(SDL_Surface* surface, Renderer *renderer, bool deep_copy = false);
+        enum Status {
+            Ready,
+            Pending,
+            Failed
+        };
+        /// Called on the render thread once an asynchronous load is done.
+        using LoadCallback = std::function<void(Texture* texture, bool loaded)>;
+
         explicit Texture(Renderer* renderer, SDL_PixelFormat format, int width, int height, SDL_TextureAccess access);
+        /// Loads `path` in the background, see `setImagePathAsync()`.
+        explicit Texture(const std::string &path, Renderer *renderer, LoadCallback on_loaded);
         ~Texture();
 
         Renderer* render() const;
 
         bool setImagePath(const std::string& path);
+        /// Decodes `path` on the renderer's texture loader and uploads it during a later
+        /// frame. The texture is `Pending` until then and keeps drawing its previous image,
+        /// if it has one.
+        bool setImagePathAsync(const std::string& path, LoadCallback on_loaded = {});
+        /// Drops a pending asynchronous load without calling its callback.
+        void cancelLoad();
+        [[nodiscard]] Status status() const;
         [[nodiscard]] const std::string& imagePath() const;
         bool setImageFromSurface(SDL_Surface* surface, bool deep_copy = false);
 
@@ -376,11 +435,16 @@ namespace MyEngine {
 
         virtual void draw();
     private:
+        void finishLoad(SDL_Surface* surface);
+
         SDL_Surface* _surface;
         SDL_Texture* _texture;
         std::string _path;
         std::unique_ptr<TextureProperty> _property;
         Renderer* _renderer;
+        Status _status{Ready};
+        uint64_t _load_id{0};
+        LoadCallback _on_loaded;
     };
 
     class TextureAtlas : public Texture {
@@ -463,6 +527,47 @@ namespace MyEngine {
         uint64_t _start_time{};
         bool _null{true}, _playing{false};
     };
+
+    /// Renders the draw calls recorded between `begin()` and `end()` into a target
+    /// texture once; later frames only draw that texture, until the content is
+    /// recorded again or the layer is resized. A layer with a size of 0 follows the
+    /// renderer's output size.
+    class RenderLayer {
+    public:
+        RenderLayer(const RenderLayer &) = delete;
+        RenderLayer(RenderLayer &&) = delete;
+        RenderLayer &operator=(const RenderLayer &) = delete;
+        RenderLayer &operator=(RenderLayer &&) = delete;
+        explicit RenderLayer(Renderer* renderer, int width = 0, int height = 0);
+        ~RenderLayer();
+
+        [[nodiscard]] Renderer* render() const;
+        void begin();
+        void end();
+        /// Ask the owner to record the content again.
+        void markDirty();
+        [[nodiscard]] bool dirty() const;
+
+        void resize(int width, int height);
+        [[nodiscard]] Size size() const;
+        void setPosition(const Vector2& position);
+        [[nodiscard]] const Vector2& position() const;
+        /// The target texture, created the first time the layer is composited.
+        [[nodiscard]] Texture* texture() const;
+
+        void draw();
+        /// Called by the renderer while the frame is executed.
+        void composite(const RenderCommand::RenderContext& context);
+    private:
+        bool updateTexture();
+
+        Renderer* _renderer;
+        std::unique_ptr<Texture> _texture;
+        RenderCommand::RenderList _list;
+        Vector2 _position{};
+        int _width, _height;
+        bool _needs_render{true};
+    };
 }
 #include "Core.h"
 #endif // !MYENGINE_COMPONETS_H
\ No newline at end of file
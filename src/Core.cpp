@@ -2,7 +2,6 @@
 #include "Core.h"
 #include "Basic.h"
 #include "Utils/All.h"
-#include "Renderer/BaseCommand.h"
 #include "Renderer/CommandFactory.h"
 
 namespace MyEngine {
@@ -12,26 +11,115 @@ namespace MyEngine {
     bool Engine::_quit_requested{false};
     int Engine::_return_code{0};
     bool Engine::_show_app_info{true};
-    bool FontDatabase::_is_loaded{false};
+    bool Engine::_headless{false};
+    std::atomic<bool> FontDatabase::_is_loaded{false};
     FontMap FontDatabase::_font_db{};
+    std::mutex FontDatabase::_mutex{};
+    std::string FontDatabase::_cache_path{};
+    /// Defined after the members it uses, so it is stopped and joined before they go away.
+    std::jthread FontDatabase::_refresh{};
 
     std::unique_ptr<TextSystem> TextSystem::_instance{};
     std::unique_ptr<AudioSystem> AudioSystem::_instance{};
 
+    CommandRecorder::CommandRecorder(SDL_Renderer* renderer) : _renderer(renderer), _snapshot_batch(renderer) {
+        _snapshot_batch.setCaptureMode(true);
+    }
+
+    CommandRecorder::~CommandRecorder() {
+        if (_recording) endRecord();
+        for (auto& buffer : _cmd_buffers) {
+            buffer.clear();
+        }
+    }
+
+    void CommandRecorder::inherit(const CommandRecorder& other) {
+        _renderer = other._renderer;
+        _blend_mode = other._blend_mode;
+        _sort_enabled = other._sort_enabled;
+        _layer = other._layer;
+        _culling_enabled = other._culling_enabled;
+        _cull_viewport = other._cull_viewport;
+        _cull_clip = other._cull_clip;
+        _cull_rect = other._cull_rect;
+        _cull_viewport_set = other._cull_viewport_set;
+        _cull_clip_set = other._cull_clip_set;
+        _cull_bounded = other._cull_bounded;
+        _cull_scaled = other._cull_scaled;
+        _stats_enabled = other._stats_enabled;
+        _glyph_atlas = other._glyph_atlas;
+        _snapshot = other._snapshot;
+    }
+
+    void CommandRecorder::resetFrameState() {
+        _sort_pending = false;
+        _layered = false;
+        _layer = 0;
+        _segment = 0;
+        _culled_count = 0;
+        _cull_changes = 0;
+    }
+
+    void CommandRecorder::swapBuffers() {
+        _cmd_buffer = &backBuffer();
+        if (!_recording) _target = _cmd_buffer;
+    }
+
+    RenderCommand::CommandBuffer& CommandRecorder::backBuffer() {
+        return _cmd_buffer == &_cmd_buffers[0] ? _cmd_buffers[1] : _cmd_buffers[0];
+    }
+
+    void CommandRecorder::pushSnapshot(uint8_t flags, uint64_t sort_key) {
+        _snapshot_batch.flush();
+        auto& arena = _target->arena();
+        const auto& vertices = _snapshot_batch.vertices();
+        const auto& indices = _snapshot_batch.indices();
+        for (auto& run : _snapshot_batch.runs()) {
+            _target->push(RenderCommand::GeometryCMD{run.texture,
+                          arena.copy(vertices.data() + run.first_vertex, run.vertex_count),
+                          arena.copy(indices.data() + run.first_index, run.index_count),
+                          static_cast<uint32_t>(run.vertex_count), static_cast<uint32_t>(run.index_count)},
+                          flags, sort_key);
+        }
+        _snapshot_batch.clear();
+    }
+
+    Vector2* const* CommandRecorder::copyPositions(std::span<Vector2* const> positions) {
+        auto& arena = _target->arena();
+        if (!_snapshot || _recording) return arena.copy(positions);
+        auto values = static_cast<Vector2*>(arena.allocate(sizeof(Vector2) * positions.size(), alignof(Vector2)));
+        auto list = static_cast<Vector2**>(arena.allocate(sizeof(Vector2*) * positions.size(), alignof(Vector2*)));
+        for (size_t i = 0; i < positions.size(); ++i) {
+            list[i] = positions[i] ? new (values + i) Vector2(*positions[i]) : nullptr;
+        }
+        return list;
+    }
+
     Renderer::Renderer(Window* window) : _window(window) {
-        _renderer = SDL_CreateRenderer(_window->self(), nullptr);
+        _renderer = SDL_CreateRenderer(_window->self(), Engine::headless() ? "software" : nullptr);
         if (!_renderer) {
             Logger::log("The renderer is not created!", Logger::Fatal);
             Engine::throwFatalError();
         }
+        _geometry_batch.setRenderer(_renderer);
+        _geometry_batch.setCounters(&_draw_counters);
+        _snapshot_batch.setRenderer(_renderer);
+        _state_cache.setRenderer(_renderer);
+        _text_cache.setRenderer(_renderer);
+        _context = {_renderer, &_geometry_batch, &_state_cache, false, &_draw_counters};
+        resetCullState();
     }
 
     Renderer::~Renderer() {
-        if (!_cmd_list.empty()) {
-            for (auto& cmd : _cmd_list) {
-                RenderCommand::CommandFactory::release(std::move(cmd));
-            }
-        }
+        setPipelineEnabled(false);
+        if (_recording) endRecord();
+        for (auto& buffer : _cmd_buffers) {
+            buffer.clear();
+        }
+        _recorders.clear();
+        _glyphs.reset();
+        _text_cache.clear();
+        destroyReleasedTextures(UINT64_MAX);
         if (_renderer) SDL_DestroyRenderer(_renderer);
     }
 
@@ -44,150 +132,835 @@ namespace MyEngine {
     }
 
     void Renderer::_update() {
-        SDL_SetRenderDrawColor(_renderer, _background_color.r, _background_color.g,
-                                _background_color.b, _background_color.a);
+        if (_sort_pending) _cmd_buffer->sort();
+        mergeRecorders();
+        /// The commands of this frame were counted when they were submitted.
+        FrameStats stats = std::move(_stats_current);
+        _stats_current = {};
+        stats.culled = _culled_count;
+        auto& frame = *_cmd_buffer;
+        ++_frame_index;
+        /// A frame recorded before the pipeline started may still point at live objects.
+        if (_pipeline.joinable() && _frame_snapshot) {
+            swapBuffers();
+            for (auto& recorder : _recorders) {
+                if (recorder) recorder->swapBuffers();
+            }
+            resetCullState(true);
+            resetFrameState();
+            _pipeline_state.store(PIPELINE_PAINTING, std::memory_order_release);
+            _pipeline_state.notify_one();
+            renderFrame(frame, stats);
+            _pipeline_state.wait(PIPELINE_PAINTING, std::memory_order_acquire);
+            clearFrame(true);
+            /// The paint thread is idle, so the stats can change under no one. The frame it
+            /// just recorded may still draw the textures replaced here, so they are released
+            /// instead of destroyed.
+            publishFrameStats(stats);
+            _texture_loader.upload();
+            return;
+        }
+        renderFrame(frame, stats);
+        clearFrame(false);
+        resetCullState();
+        resetFrameState();
+        _frame_snapshot = _snapshot;
+        /// Between the rendered frame and the next recorded one.
+        publishFrameStats(stats);
+        _texture_loader.upload();
+        _window->paintEvent();
+    }
+
+    void Renderer::renderFrame(RenderCommand::CommandBuffer& frame, FrameStats& stats) {
+        const uint64_t START = _stats_enabled ? SDL_GetPerformanceCounter() : 0;
+        _draw_counters.reset();
+        _state_cache.resetCounters();
+        /// Someone else may have touched the renderer between two frames.
+        _state_cache.invalidate();
+        _state_cache.setDrawColor(_background_color);
         SDL_RenderClear(_renderer);
-        for (auto& cmd : _cmd_list) {
-            cmd->exec();
-            RenderCommand::CommandFactory::release(std::move(cmd));
+        _context.countDraw();
+        for (auto header : frame.records()) {
+            /// Batchable commands keep appending to the open batch; any other command
+            /// may change the render state, so the pending geometry goes first.
+            if (!(header->flags & RenderCommand::CommandHeader::Batchable)) {
+                _geometry_batch.flush();
+            }
+            RenderCommand::execute(header, _context);
         }
+        _geometry_batch.flush();
+        if (_frame_hash_enabled) _frame_hash.store(hashFramePixels(), std::memory_order_relaxed);
+        const uint64_t EXECUTED = _stats_enabled ? SDL_GetPerformanceCounter() : 0;
         SDL_RenderPresent(_renderer);
-        _cmd_list.clear();
-        _window->paintEvent();
+        /// No quad refers to a glyph page any more until the next frame is rendered.
+        if (_glyphs) _glyphs->trim();
+        _text_cache.collect(_frame_index - 1);
+        destroyReleasedTextures(_frame_index - 1);
+        if (_stats_enabled) finishFrameStats(stats, START, EXECUTED, SDL_GetPerformanceCounter());
     }
 
-    void Renderer::fillBackground(const SDL_Color &color) {
-        addCommand<RenderCommand::FillCMD>(_renderer, color);
+    void Renderer::clearFrame(bool back_buffers) {
+        (back_buffers ? backBuffer() : *_cmd_buffer).clear();
+        for (auto& recorder : _recorders) {
+            if (recorder) (back_buffers ? recorder->backBuffer() : *recorder->_cmd_buffer).clear();
+        }
     }
 
-    void Renderer::fillBackground(SDL_Color &&color) {
-        addCommand<RenderCommand::FillCMD>(_renderer, std::move(color));
+    void Renderer::pipelineLoop() {
+        while (true) {
+            _pipeline_state.wait(PIPELINE_IDLE, std::memory_order_acquire);
+            if (_pipeline_state.load(std::memory_order_acquire) == PIPELINE_STOPPING) return;
+            _window->paintEvent();
+            _pipeline_state.store(PIPELINE_IDLE, std::memory_order_release);
+            _pipeline_state.notify_one();
+        }
     }
 
-    void Renderer::fillBackground(uint64_t rgb_hex) {
-        addCommand<RenderCommand::FillCMD>(_renderer, RGBAColor::RGBAValue2Color(rgb_hex));
+    void Renderer::setPipelineEnabled(bool enabled) {
+        if (enabled == _pipeline.joinable()) return;
+        if (std::this_thread::get_id() == _pipeline.get_id()) {
+            Logger::log("Renderer: The pipeline can't be stopped from its own paint event!", Logger::Warn);
+            return;
+        }
+        if (enabled) {
+            _snapshot = true;
+            _pipeline_state.store(PIPELINE_IDLE, std::memory_order_relaxed);
+            _pipeline = std::thread(&Renderer::pipelineLoop, this);
+        } else {
+            _pipeline_state.store(PIPELINE_STOPPING, std::memory_order_release);
+            _pipeline_state.notify_one();
+            _pipeline.join();
+            _snapshot = false;
+        }
+    }
+
+    bool Renderer::pipelineEnabled() const {
+        return _pipeline.joinable();
+    }
+
+    void Renderer::finishFrameStats(FrameStats& stats, uint64_t start, uint64_t executed, uint64_t presented) {
+        const double TO_MS = 1000.0 / static_cast<double>(SDL_GetPerformanceFrequency());
+        const uint64_t HITS = RenderCommand::AbstractCommandPool::totalHits();
+        const uint64_t MISSES = RenderCommand::AbstractCommandPool::totalMisses();
+        stats.frame = ++_stats_frame;
+        stats.draw_calls = _draw_counters.draw_calls;
+        stats.vertices = _draw_counters.vertices;
+        stats.indices = _draw_counters.indices;
+        stats.state_changes = _state_cache.issuedCount();
+        stats.state_skipped = _state_cache.skippedCount();
+        stats.pool_hits = HITS - _pool_hits_mark;
+        stats.pool_misses = MISSES - _pool_misses_mark;
+        stats.execute_time = static_cast<double>(executed - start) * TO_MS;
+        stats.present_time = static_cast<double>(presented - executed) * TO_MS;
+        _pool_hits_mark = HITS;
+        _pool_misses_mark = MISSES;
+    }
+
+    void Renderer::publishFrameStats(FrameStats& stats) {
+        if (!stats.frame) return;
+        if (_stats_history_size) {
+            if (_stats_history.size() >= _stats_history_size) _stats_history.pop_front();
+            _stats_history.push_back(stats);
+        }
+        _stats = std::move(stats);
+    }
+
+    void Renderer::mergeRecorders() {
+        bool merged = false, layered = _layered;
+        for (size_t i = 0; i < _recorders.size(); ++i) {
+            if (!_recorders[i]) continue;
+            _recorders_bound[i] = false;
+            auto& recorder = *_recorders[i];
+            if (recorder._recording) {
+                Logger::log(std::format("Renderer: Recorder {} is still recording a render list!", i),
+                            Logger::Warn);
+                recorder.endRecord();
+            }
+            _culled_count += recorder._culled_count;
+            /// Their commands run after the own ones, in an order culling doesn't follow.
+            if (recorder._cull_changes) _cull_changes |= ViewUnknown;
+            if (_stats_enabled) {
+                for (size_t t = 0; t < recorder._stats_current.commands.size(); ++t) {
+                    _stats_current.commands[t] += recorder._stats_current.commands[t];
+                }
+                for (auto& [name, count] : recorder._stats_current.custom_commands) {
+                    _stats_current.custom_commands[name] += count;
+                }
+            }
+            recorder._stats_current = {};
+            if (!recorder._cmd_buffer->empty()) {
+                if (recorder._sort_pending) recorder._cmd_buffer->sort();
+                _cmd_buffer->adopt(*recorder._cmd_buffer);
+                layered |= recorder._layered;
+                merged = true;
+            }
+            recorder.resetFrameState();
+        }
+        /// Every buffer is in order already; only layers can interleave them.
+        if (merged && layered) _cmd_buffer->sortLayers();
+    }
+
+    CommandRecorder* Renderer::recorder(uint8_t slot) {
+        if (slot >= _recorders.size()) {
+            _recorders.resize(slot + 1);
+            _recorders_bound.resize(slot + 1, false);
+        }
+        if (!_recorders[slot]) _recorders[slot] = std::make_unique<CommandRecorder>(_renderer);
+        if (!_recorders_bound[slot]) {
+            _recorders[slot]->inherit(*this);
+            _recorders_bound[slot] = true;
+        }
+        return _recorders[slot].get();
+    }
+
+    uint64_t CommandRecorder::nextSortKey(uint8_t flags, uint32_t state) {
+        static constexpr uint32_t SEGMENT_MAX = 0xFFFFFF;
+        if (flags & RenderCommand::CommandHeader::Sortable) {
+            _sort_pending = true;
+        } else if (_segment < SEGMENT_MAX) {
+            ++_segment;
+        }
+        if (_layer != 0) _sort_pending = _layered = true;
+        return RenderCommand::packSortKey(_layer, _segment, state);
+    }
+
+    void Renderer::resetCullState(bool in_flight) {
+        _last_culled_count = _culled_count;
+        _culled_count = 0;
+        const uint8_t CHANGES = _cull_changes;
+        const SDL_Rect VIEWPORT = _cull_viewport, CLIP = _cull_clip;
+        const bool VIEWPORT_SET = _cull_viewport_set, CLIP_SET = _cull_clip_set;
+        /// SDL holds the state the last recorded frame starts from, which is where new
+        /// draws start unless that frame is still to be rendered.
+        _cull_viewport_set = SDL_GetRenderViewport(_renderer, &_cull_viewport);
+        _cull_clip_set = SDL_RenderClipEnabled(_renderer) && SDL_GetRenderClipRect(_renderer, &_cull_clip);
+        float scale_x = 1.f, scale_y = 1.f;
+        SDL_GetRenderScale(_renderer, &scale_x, &scale_y);
+        _cull_scaled = (scale_x != 1.f || scale_y != 1.f);
+        if (in_flight) {
+            /// Then its own viewport and clip commands decide where it ends, as tracked
+            /// while it was recorded.
+            if (CHANGES & ViewportChanged) {
+                _cull_viewport = VIEWPORT;
+                _cull_viewport_set = VIEWPORT_SET;
+            }
+            if (CHANGES & ClipChanged) {
+                _cull_clip = CLIP;
+                _cull_clip_set = CLIP_SET;
+            }
+            /// Nothing to go by; cull nothing rather than the wrong things.
+            if (CHANGES & ViewUnknown) _cull_viewport_set = _cull_clip_set = false;
+        }
+        updateCullRect();
+    }
+
+    void CommandRecorder::updateCullRect() {
+        _cull_bounded = false;
+        /// Scaled rendering is left alone rather than guessing the mapping wrong.
+        if (_cull_scaled) return;
+        if (_cull_viewport_set) {
+            _cull_rect = {0.f, 0.f, static_cast<float>(_cull_viewport.w), static_cast<float>(_cull_viewport.h)};
+            _cull_bounded = true;
+        }
+        if (_cull_clip_set) {
+            const SDL_FRect CLIP = {static_cast<float>(_cull_clip.x), static_cast<float>(_cull_clip.y),
+                                    static_cast<float>(_cull_clip.w), static_cast<float>(_cull_clip.h)};
+            if (!_cull_bounded) {
+                _cull_rect = CLIP;
+                _cull_bounded = true;
+            } else if (!SDL_GetRectIntersectionFloat(&_cull_rect, &CLIP, &_cull_rect)) {
+                _cull_rect = {0.f, 0.f, 0.f, 0.f};
+            }
+        }
     }
 
-    void Renderer::drawPoint(Graphics::Point *point) {
-        addCommand<RenderCommand::PointCMD>(_renderer, point);
+    bool CommandRecorder::visible(const SDL_FRect& bounds) {
+        if (!_culling_enabled || !_cull_bounded || _recording) return true;
+        /// Touching edges count as visible; this only has to be conservative.
+        if (bounds.x > _cull_rect.x + _cull_rect.w || bounds.x + bounds.w < _cull_rect.x ||
+            bounds.y > _cull_rect.y + _cull_rect.h || bounds.y + bounds.h < _cull_rect.y) {
+            ++_culled_count;
+            return false;
+        }
+        return true;
     }
 
-    void Renderer::drawPoints(const std::vector<Graphics::Point*>& point_list) {
-        addCommand<RenderCommand::PointCMD>(_renderer, nullptr,
-                        RenderCommand::BaseCommand::Mode::Multiple, point_list.size(), point_list);
+    template<typename T>
+    T** CommandRecorder::visibleItems(std::span<T* const> items, uint32_t& count) {
+        auto list = static_cast<T**>(_target->arena().allocate(sizeof(T*) * items.size(), alignof(T*)));
+        count = 0;
+        for (auto item : items) {
+            if (item && visible(item->bounds())) list[count++] = item;
+        }
+        return list;
     }
 
-    void Renderer::drawLine(Graphics::Line *line) {
-        addCommand<RenderCommand::LineCMD>(_renderer, line);
+    void CommandRecorder::fillBackground(const SDL_Color &color) {
+        addCommand(RenderCommand::FillCMD{color});
     }
 
-    void Renderer::drawLines(const std::vector<Graphics::Line*>& line_list) {
-        addCommand<RenderCommand::LineCMD>(_renderer, nullptr,
-                       RenderCommand::BaseCommand::Mode::Multiple, line_list.size(), line_list);
+    void CommandRecorder::fillBackground(SDL_Color &&color) {
+        addCommand(RenderCommand::FillCMD{color});
     }
 
-    void Renderer::drawRectangle(Graphics::Rectangle* rectangle) {
-        addCommand<RenderCommand::RectangleCMD>(_renderer, rectangle);
+    void CommandRecorder::fillBackground(uint64_t rgb_hex) {
+        addCommand(RenderCommand::FillCMD{RGBAColor::RGBAValue2Color(rgb_hex)});
     }
 
-    void Renderer::drawRectangles(const std::vector<Graphics::Rectangle*> &rectangle_list) {
-        addCommand<RenderCommand::RectangleCMD>(_renderer, nullptr,
-                        RenderCommand::BaseCommand::Mode::Multiple, rectangle_list.size(), rectangle_list);
+    void CommandRecorder::drawPoint(Graphics::Point *point) {
+        if (!point || !visible(point->bounds())) return;
+        addCommand(RenderCommand::PointCMD{point, RenderCommand::Mode::Single, 1, nullptr});
     }
 
-    void Renderer::drawTriangle(Graphics::Triangle* triangle) {
-        addCommand<RenderCommand::TriangleCMD>(_renderer, triangle);
+    void CommandRecorder::drawPoints(std::span<Graphics::Point* const> point_list) {
+        if (point_list.empty()) return;
+        uint32_t count = 0;
+        auto items = visibleItems(point_list, count);
+        if (!count) return;
+        addCommand(RenderCommand::PointCMD{nullptr, RenderCommand::Mode::Multiple, count, items});
     }
 
-    void Renderer::drawTriangles(const std::vector<Graphics::Triangle*> &triangle_list) {
-        addCommand<RenderCommand::TriangleCMD>(_renderer, nullptr,
-                       RenderCommand::BaseCommand::Mode::Multiple, triangle_list.size(), triangle_list);
+    void CommandRecorder::drawLine(Graphics::Line *line) {
+        if (!line || !visible(line->bounds())) return;
+        addCommand(RenderCommand::LineCMD{line, RenderCommand::Mode::Single, 1, nullptr});
     }
 
-    void Renderer::drawEllipse(Graphics::Ellipse *ellipse) {
-        addCommand<RenderCommand::EllipseCMD>(_renderer, ellipse);
+    void CommandRecorder::drawLines(std::span<Graphics::Line* const> line_list) {
+        if (line_list.empty()) return;
+        uint32_t count = 0;
+        auto items = visibleItems(line_list, count);
+        if (!count) return;
+        addCommand(RenderCommand::LineCMD{nullptr, RenderCommand::Mode::Multiple, count, items});
     }
 
-    void Renderer::drawEllipses(const std::vector<Graphics::Ellipse*> &ellipse_list) {
-        addCommand<RenderCommand::EllipseCMD>(_renderer, nullptr,
-                      RenderCommand::BaseCommand::Mode::Multiple, ellipse_list.size(), ellipse_list);
+    void CommandRecorder::drawRectangle(Graphics::Rectangle* rectangle) {
+        if (!rectangle || !visible(rectangle->bounds())) return;
+        addCommand(RenderCommand::RectangleCMD{rectangle, RenderCommand::Mode::Single, 1, nullptr});
     }
 
-    void Renderer::drawTexture(SDL_Texture* texture, TextureProperty* property) {
-        if (!texture || !property) return;
-        addCommand<RenderCommand::TextureCMD>(_renderer, texture, property);
+    void CommandRecorder::drawRectangles(std::span<Graphics::Rectangle* const> rectangle_list) {
+        if (rectangle_list.empty()) return;
+        uint32_t count = 0;
+        auto items = visibleItems(rectangle_list, count);
+        if (!count) return;
+        addCommand(RenderCommand::RectangleCMD{nullptr, RenderCommand::Mode::Multiple, count, items});
     }
 
-    void Renderer::drawTexture(SDL_Texture* texture, const std::vector<TextureProperty*>& properties) {
-        if (!texture || properties.empty()) return;
-        addCommand<RenderCommand::TextureCMD>(_renderer, texture, nullptr, RenderCommand::BaseCommand::Mode::Multiple,
-                                  properties.size(), properties);
+    void CommandRecorder::drawTriangle(Graphics::Triangle* triangle) {
+        if (!triangle || !visible(triangle->bounds())) return;
+        addCommand(RenderCommand::TriangleCMD{triangle, RenderCommand::Mode::Single, 1, nullptr});
     }
 
-    void Renderer::drawTextures(const std::vector<SDL_Texture*>& textures,
-                                const std::vector<TextureProperty*>& properties) {
-        addCommand<RenderCommand::TextureCMD>(_renderer, nullptr, nullptr, RenderCommand::BaseCommand::Mode::Custom,
-                                  properties.size(), properties, textures);
+    void CommandRecorder::drawTriangles(std::span<Graphics::Triangle* const> triangle_list) {
+        if (triangle_list.empty()) return;
+        uint32_t count = 0;
+        auto items = visibleItems(triangle_list, count);
+        if (!count) return;
+        addCommand(RenderCommand::TriangleCMD{nullptr, RenderCommand::Mode::Multiple, count, items});
     }
 
-    void Renderer::drawText(TTF_Text* text, Vector2& position) {
-        if (!text) return;
-        addCommand<RenderCommand::TextCMD>(_renderer, text, position);
+    void CommandRecorder::drawEllipse(Graphics::Ellipse *ellipse) {
+        if (!ellipse || !visible(ellipse->bounds())) return;
+        addCommand(RenderCommand::EllipseCMD{ellipse, RenderCommand::Mode::Single, 1, nullptr});
+    }
+
+    void CommandRecorder::drawEllipses(std::span<Graphics::Ellipse* const> ellipse_list) {
+        if (ellipse_list.empty()) return;
+        uint32_t count = 0;
+        auto items = visibleItems(ellipse_list, count);
+        if (!count) return;
+        addCommand(RenderCommand::EllipseCMD{nullptr, RenderCommand::Mode::Multiple, count, items});
+    }
+
+    bool CommandRecorder::instanceArrays(const char* function, size_t count, std::initializer_list<size_t> sizes) {
+        for (auto size : sizes) {
+            if (size != 1 && size != count) {
+                Logger::log(std::format("Renderer: {}: Expected 1 or {} entries per array, got {}!",
+                                        function, count, size), Logger::Warn);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template<typename T>
+    const T* CommandRecorder::copyInstances(std::span<const T> data, std::span<const uint32_t> visible) {
+        if (data.size() <= 1 || visible.size() == data.size()) return _target->arena().copy(data);
+        auto list = static_cast<T*>(_target->arena().allocate(sizeof(T) * visible.size(), alignof(T)));
+        for (size_t i = 0; i < visible.size(); ++i) {
+            list[i] = data[visible[i]];
+        }
+        return list;
+    }
+
+    void CommandRecorder::drawInstances(RenderCommand::InstancesCMD command, std::span<const SDL_FRect> bounds,
+                                        std::span<const Vector2> positions, std::span<const Vector2> ends,
+                                        std::span<const Size> sizes, std::span<const float> values,
+                                        std::span<const float> rotations, std::span<const SDL_Color> colors) {
+        thread_local std::vector<uint32_t> items;
+        items.clear();
+        for (uint32_t i = 0; i < positions.size(); ++i) {
+            if (visible(bounds[i])) items.push_back(i);
+        }
+        if (items.empty()) return;
+        command.count = static_cast<uint32_t>(items.size());
+        command.positions = copyInstances(positions, items);
+        command.ends = copyInstances(ends, items);
+        command.sizes = copyInstances(sizes, items);
+        command.values = copyInstances(values, items);
+        command.value_count = values.size() > 1 ? command.count : values.size();
+        command.rotations = copyInstances(rotations, items);
+        command.rotation_count = rotations.size() > 1 ? command.count : rotations.size();
+        command.colors = copyInstances(colors, items);
+        command.color_count = colors.size() > 1 ? command.count : colors.size();
+        addCommand(command);
+    }
+
+    void CommandRecorder::drawCircles(std::span<const Vector2> centers, std::span<const float> radii,
+                                      std::span<const SDL_Color> colors, uint16_t segment) {
+        if (centers.empty() || radii.empty() || colors.empty()) return;
+        if (!instanceArrays("drawCircles", centers.size(), {radii.size(), colors.size()})) return;
+        thread_local std::vector<SDL_FRect> bounds;
+        bounds.resize(centers.size());
+        for (size_t i = 0; i < centers.size(); ++i) {
+            const float R = radii[radii.size() > 1 ? i : 0];
+            bounds[i] = {centers[i].x - R, centers[i].y - R, R * 2, R * 2};
+        }
+        drawInstances({RenderCommand::InstancesCMD::Shape::Circle, segment}, bounds,
+                      centers, {}, {}, radii, {}, colors);
+    }
+
+    void CommandRecorder::drawRects(std::span<const Vector2> positions, std::span<const Size> sizes,
+                                    std::span<const SDL_Color> colors, std::span<const float> rotations) {
+        if (positions.empty() || colors.empty()) return;
+        if (sizes.size() != positions.size()) {
+            Logger::log(std::format("Renderer: drawRects: Expected {} sizes, got {}!",
+                                    positions.size(), sizes.size()), Logger::Warn);
+            return;
+        }
+        if (!instanceArrays("drawRects", positions.size(), {colors.size()})) return;
+        if (!rotations.empty() && !instanceArrays("drawRects", positions.size(), {rotations.size()})) return;
+        thread_local std::vector<SDL_FRect> bounds;
+        bounds.resize(positions.size());
+        for (size_t i = 0; i < positions.size(); ++i) {
+            const float HW = sizes[i].width * 0.5f, HH = sizes[i].height * 0.5f;
+            /// A rotated rectangle stays within the circle through its corners.
+            const float R = rotations.empty() ? 0.f : std::sqrt(HW * HW + HH * HH);
+            const float EX = rotations.empty() ? HW : R, EY = rotations.empty() ? HH : R;
+            bounds[i] = {positions[i].x + HW - EX, positions[i].y + HH - EY, EX * 2, EY * 2};
+        }
+        drawInstances({RenderCommand::InstancesCMD::Shape::Rectangle}, bounds,
+                      positions, {}, sizes, {}, rotations, colors);
+    }
+
+    void CommandRecorder::drawLines(std::span<const Vector2> starts, std::span<const Vector2> ends,
+                                    std::span<const float> thickness, std::span<const SDL_Color> colors) {
+        if (starts.empty() || thickness.empty() || colors.empty()) return;
+        if (ends.size() != starts.size()) {
+            Logger::log(std::format("Renderer: drawLines: Expected {} ends, got {}!",
+                                    starts.size(), ends.size()), Logger::Warn);
+            return;
+        }
+        if (!instanceArrays("drawLines", starts.size(), {thickness.size(), colors.size()})) return;
+        thread_local std::vector<SDL_FRect> bounds;
+        bounds.resize(starts.size());
+        for (size_t i = 0; i < starts.size(); ++i) {
+            const float T = thickness[thickness.size() > 1 ? i : 0];
+            const float X = std::min(starts[i].x, ends[i].x), Y = std::min(starts[i].y, ends[i].y);
+            bounds[i] = {X - T, Y - T, std::abs(ends[i].x - starts[i].x) + T * 2,
+                         std::abs(ends[i].y - starts[i].y) + T * 2};
+        }
+        drawInstances({RenderCommand::InstancesCMD::Shape::Line}, bounds,
+                      starts, ends, {}, thickness, {}, colors);
+    }
+
+    void CommandRecorder::drawTexture(SDL_Texture* texture, TextureProperty* property) {
+        if (!texture || !property || !visible(property->bounds())) return;
+        addCommand(RenderCommand::TextureCMD{texture, property, RenderCommand::Mode::Single, 1,
+                                             nullptr, nullptr});
+    }
+
+    void CommandRecorder::drawTexture(SDL_Texture* texture, std::span<TextureProperty* const> properties) {
+        if (!texture || properties.empty()) return;
+        uint32_t count = 0;
+        auto items = visibleItems(properties, count);
+        if (!count) return;
+        addCommand(RenderCommand::TextureCMD{texture, nullptr, RenderCommand::Mode::Multiple,
+                   count, items, nullptr});
+    }
+
+    void CommandRecorder::drawTextures(std::span<SDL_Texture* const> textures,
+                                std::span<TextureProperty* const> properties) {
+        if (properties.empty()) return;
+        if (textures.size() != properties.size()) {
+            Logger::log("Renderer: The count of textures and properties is not matched!", Logger::Warn);
+            return;
+        }
+        auto& arena = _target->arena();
+        auto props = static_cast<TextureProperty**>(arena.allocate(sizeof(TextureProperty*) * properties.size(),
+                                                                   alignof(TextureProperty*)));
+        auto texs = static_cast<SDL_Texture**>(arena.allocate(sizeof(SDL_Texture*) * textures.size(),
+                                                              alignof(SDL_Texture*)));
+        uint32_t count = 0;
+        for (size_t i = 0; i < properties.size(); ++i) {
+            if (!textures[i] || !properties[i] || !visible(properties[i]->bounds())) continue;
+            props[count] = properties[i];
+            texs[count++] = textures[i];
+        }
+        if (!count) return;
+        addCommand(RenderCommand::TextureCMD{nullptr, nullptr, RenderCommand::Mode::Custom,
+                   count, props, texs});
+    }
+
+    bool CommandRecorder::drawAtlasText(TTF_Text* text, const Vector2& position) {
+        int wrap_width = 0;
+        if (!_glyph_atlas || !text->text || (TTF_GetTextWrapWidth(text, &wrap_width) && wrap_width > 0)) {
+            return false;
+        }
+        auto font = TTF_GetTextFont(text);
+        if (!font) return false;
+        SDL_Color color{255, 255, 255, 255};
+        TTF_GetTextColor(text, &color.r, &color.g, &color.b, &color.a);
+        drawGlyphText(font, text->text, position, color);
+        return true;
     }
 
-    void Renderer::drawTexts(TTF_Text* text, const std::vector<Vector2*>& position_list) {
+    void CommandRecorder::drawText(TTF_Text* text, Vector2& position) {
         if (!text) return;
-        addCommand<RenderCommand::TextCMD>(_renderer, text, Vector2(), RenderCommand::BaseCommand::Mode::Multiple,
-                                           position_list.size(), position_list);
+        if (drawAtlasText(text, position)) return;
+        addCommand(RenderCommand::TextCMD{text, position, RenderCommand::Mode::Single, 1, nullptr, nullptr});
+    }
+
+    void CommandRecorder::drawTexts(TTF_Text* text, std::span<Vector2* const> position_list) {
+        if (!text || position_list.empty()) return;
+        if (_glyph_atlas) {
+            for (auto position : position_list) {
+                if (position && !drawAtlasText(text, *position)) drawText(text, *position);
+            }
+            return;
+        }
+        addCommand(RenderCommand::TextCMD{text, Vector2(), RenderCommand::Mode::Multiple,
+                   static_cast<uint32_t>(position_list.size()),
+                   copyPositions(position_list), nullptr});
+    }
+
+    void CommandRecorder::drawTexts(std::span<TTF_Text* const> text_list, std::span<Vector2* const> position_list) {
+        if (text_list.empty()) return;
+        if (text_list.size() != position_list.size()) {
+            Logger::log("Renderer: The count of texts and positions is not matched!", Logger::Warn);
+            return;
+        }
+        if (_glyph_atlas) {
+            for (size_t i = 0; i < text_list.size(); ++i) {
+                if (!text_list[i] || !position_list[i]) continue;
+                if (!drawAtlasText(text_list[i], *position_list[i])) {
+                    drawText(text_list[i], *position_list[i]);
+                }
+            }
+            return;
+        }
+        auto& arena = _target->arena();
+        addCommand(RenderCommand::TextCMD{nullptr, Vector2(), RenderCommand::Mode::Custom,
+                   static_cast<uint32_t>(position_list.size()),
+                   copyPositions(position_list),
+                   arena.copy(text_list)});
     }
 
-    void Renderer::drawTexts(const std::vector<TTF_Text*>& text_list, const std::vector<Vector2*>& position_list) {
-        addCommand<RenderCommand::TextCMD>(_renderer, nullptr, Vector2(), RenderCommand::BaseCommand::Mode::Multiple,
-                                           position_list.size(), position_list, text_list);
+    void CommandRecorder::drawGlyphText(TTF_Font* font, std::string_view text, const Vector2& position,
+                                        const SDL_Color& color, float size) {
+        if (!font || text.empty()) return;
+        if (!_glyph_atlas) {
+            Logger::log("Renderer: Can't draw glyph text! The glyph atlas is not enabled.", Logger::Warn);
+            return;
+        }
+        addCommand(RenderCommand::GlyphTextCMD{_glyph_atlas, font, _target->arena().copyString(text),
+                   static_cast<uint32_t>(text.size()), position, color, size});
+    }
+
+    void CommandRecorder::drawNumber(TTF_Font* font, int64_t value, const Vector2& position,
+                                     const SDL_Color& color, float size) {
+        if (!font) return;
+        if (!_glyph_atlas) {
+            Logger::log("Renderer: Can't draw number! The glyph atlas is not enabled.", Logger::Warn);
+            return;
+        }
+        addCommand(RenderCommand::NumberCMD{_glyph_atlas, font, value, 0.0, -1, position, color, size});
     }
 
-    void Renderer::drawDebugText(const std::string &text, const MyEngine::Vector2 &position,
+    void CommandRecorder::drawFixed(TTF_Font* font, double value, uint8_t decimals, const Vector2& position,
+                                    const SDL_Color& color, float size) {
+        if (!font) return;
+        if (!_glyph_atlas) {
+            Logger::log("Renderer: Can't draw number! The glyph atlas is not enabled.", Logger::Warn);
+            return;
+        }
+        addCommand(RenderCommand::NumberCMD{_glyph_atlas, font, 0, value,
+                   static_cast<int8_t>(std::min<uint8_t>(decimals, 15)), position, color, size});
+    }
+
+    void CommandRecorder::drawDebugText(const std::string &text, const MyEngine::Vector2 &position,
                                  const SDL_Color& color) {
         if (text.empty()) return;
-        addCommand<RenderCommand::DebugTextCMD>(_renderer, text, position, color);
+        addCommand(RenderCommand::DebugTextCMD{_target->arena().copyString(text), position, color,
+                                               RenderCommand::Mode::Single, 1, nullptr, nullptr});
     }
 
-    void Renderer::drawDebugTexts(const StringList& text_list, const std::vector<Vector2*>& position_list,
+    void CommandRecorder::drawDebugTexts(std::span<const std::string> text_list, std::span<Vector2* const> position_list,
                                   const SDL_Color& color) {
         if (text_list.empty()) return;
-        addCommand<RenderCommand::DebugTextCMD>(_renderer, std::string(), Vector2(), color,
-                            RenderCommand::BaseCommand::Mode::Multiple, position_list.size(),
-                            text_list, position_list);
+        if (text_list.size() != position_list.size()) {
+            Logger::log("Renderer: The count of texts and positions is not matched!", Logger::Warn);
+            return;
+        }
+        auto& arena = _target->arena();
+        addCommand(RenderCommand::DebugTextCMD{nullptr, Vector2(), color, RenderCommand::Mode::Multiple,
+                   static_cast<uint32_t>(text_list.size()), arena.copyStrings(text_list),
+                   copyPositions(position_list)});
     }
 
     void Renderer::drawDebugFPS(const MyEngine::Vector2 &position, const SDL_Color &color) {
-        addCommand<RenderCommand::DebugTextCMD>(_renderer,
-                    std::format("FPS: {}", window()->_engine->fps()), position, color);
+        static constexpr size_t MAX_LENGTH = 24;
+        auto text = static_cast<char*>(_target->arena().allocate(MAX_LENGTH, 1));
+        auto result = std::format_to_n(text, MAX_LENGTH - 1, "FPS: {}", window()->_engine->fps());
+        *result.out = '\0';
+        addCommand(RenderCommand::DebugTextCMD{text, position, color, RenderCommand::Mode::Single, 1,
+                                               nullptr, nullptr});
+    }
+
+    void CommandRecorder::setViewport(const Geometry& geometry) {
+        const bool RESET = (geometry.width == 0 || geometry.height == 0);
+        addCommand(RenderCommand::ViewPortCMD{{geometry.x, geometry.y, geometry.width, geometry.height}, RESET});
+        if (!_recording) {
+            _cull_viewport = {geometry.x, geometry.y, geometry.width, geometry.height};
+            /// The full output size isn't known here, so a reset viewport just stops culling by it.
+            _cull_viewport_set = !RESET;
+            _cull_changes |= ViewportChanged;
+            updateCullRect();
+        } else {
+            _recording->_sets_view = true;
+        }
     }
 
-    void Renderer::setViewport(const Geometry& geometry) {
-        if (geometry.width == 0 || geometry.height == 0) {
-            addCommand<RenderCommand::ViewPortCMD>(_renderer, true, geometry);
+    void CommandRecorder::setClipView(const Geometry& geometry) {
+        const bool RESET = (geometry.width == 0 || geometry.height == 0);
+        addCommand(RenderCommand::ClipViewCMD{{geometry.x, geometry.y, geometry.width, geometry.height}, RESET});
+        if (!_recording) {
+            _cull_clip = {geometry.x, geometry.y, geometry.width, geometry.height};
+            _cull_clip_set = !RESET;
+            _cull_changes |= ClipChanged;
+            updateCullRect();
         } else {
-            addCommand<RenderCommand::ViewPortCMD>(_renderer, false, geometry);
+            _recording->_sets_view = true;
         }
     }
 
-    void Renderer::setClipView(const Geometry& geometry) {
-        if (geometry.width == 0 || geometry.height == 0) {
-            addCommand<RenderCommand::ClipViewCMD>(_renderer, true, geometry);
-        } else {
-            addCommand<RenderCommand::ClipViewCMD>(_renderer, false, geometry);
+    void CommandRecorder::setBlendMode(const SDL_BlendMode &blend_mode) {
+        _blend_mode = blend_mode;
+        addCommand(RenderCommand::BlendModeCMD{blend_mode});
+    }
+
+    void CommandRecorder::setSortEnabled(bool enabled) {
+        _sort_enabled = enabled;
+    }
+
+    bool CommandRecorder::sortEnabled() const {
+        return _sort_enabled;
+    }
+
+    void CommandRecorder::setLayer(int16_t layer) {
+        _layer = layer;
+    }
+
+    int16_t CommandRecorder::layer() const {
+        return _layer;
+    }
+
+    void CommandRecorder::beginRecord(RenderList* list) {
+        if (!list) return;
+        if (_recording) {
+            Logger::log("Renderer: A render list is already being recorded!", Logger::Warn);
+            return;
+        }
+        list->clear();
+        _recording = list;
+        _target = &list->_buffer;
+        _record_blend_mode = _blend_mode;
+        _record_sort_pending = _sort_pending;
+        _record_layer = _layer;
+        _sort_pending = false;
+        _layer = 0;
+    }
+
+    void CommandRecorder::endRecord() {
+        if (!_recording) {
+            Logger::log("Renderer: No render list is being recorded!", Logger::Warn);
+            return;
+        }
+        if (_sort_pending) _recording->_buffer.sort();
+        _recording->compile(_renderer);
+        _recording->_sets_blend_mode = (_blend_mode != _record_blend_mode);
+        _recording->_blend_mode = _blend_mode;
+        _blend_mode = _record_blend_mode;
+        _sort_pending = _record_sort_pending;
+        _layer = _record_layer;
+        _target = _cmd_buffer;
+        _recording = nullptr;
+    }
+
+    bool CommandRecorder::recording() const {
+        return _recording != nullptr;
+    }
+
+    void CommandRecorder::drawRenderList(RenderList* list) {
+        if (!list || list->empty()) return;
+        if (list == _recording) {
+            Logger::log("Renderer: A render list can't draw itself!", Logger::Warn);
+            return;
+        }
+        addCommand(RenderCommand::RenderListCMD{list});
+        /// Whatever blend mode the list leaves behind stays in effect.
+        if (list->_sets_blend_mode) _blend_mode = list->_blend_mode;
+        if (list->_sets_view) {
+            if (_recording) _recording->_sets_view = true;
+            else _cull_changes |= ViewUnknown;
+        }
+    }
+
+    void CommandRecorder::setCullingEnabled(bool enabled) {
+        _culling_enabled = enabled;
+    }
+
+    bool CommandRecorder::cullingEnabled() const {
+        return _culling_enabled;
+    }
+
+    uint64_t Renderer::culledCount() const {
+        return _last_culled_count;
+    }
+
+    void Renderer::setFrameHashEnabled(bool enabled) {
+        _frame_hash_enabled = enabled;
+    }
+
+    uint64_t Renderer::frameHash() const {
+        return _frame_hash.load(std::memory_order_relaxed);
+    }
+
+    void Renderer::setFrameStatsEnabled(bool enabled, size_t history_size) {
+        _stats_enabled = enabled;
+        _stats_history_size = enabled ? history_size : 0;
+        while (_stats_history.size() > _stats_history_size) _stats_history.pop_front();
+        _stats_current = {};
+        _pool_hits_mark = RenderCommand::AbstractCommandPool::totalHits();
+        _pool_misses_mark = RenderCommand::AbstractCommandPool::totalMisses();
+    }
+
+    bool Renderer::frameStatsEnabled() const {
+        return _stats_enabled;
+    }
+
+    const FrameStats& Renderer::frameStats() const {
+        return _stats;
+    }
+
+    const std::deque<FrameStats>& Renderer::frameStatsHistory() const {
+        return _stats_history;
+    }
+
+    void Renderer::setGlyphAtlasEnabled(bool enabled) {
+        if (enabled && !_glyphs) {
+            if (!_renderer) {
+                Logger::log("Renderer: Can't enable the glyph atlas without a renderer!", Logger::Warn);
+                return;
+            }
+            _glyphs = std::make_unique<RenderCommand::GlyphAtlas>(_renderer);
         }
+        _glyph_atlas = enabled ? _glyphs.get() : nullptr;
+    }
+
+    bool Renderer::glyphAtlasEnabled() const {
+        return _glyph_atlas;
+    }
+
+    RenderCommand::GlyphAtlas* Renderer::glyphAtlas() const {
+        return _glyphs.get();
     }
 
-    void Renderer::setBlendMode(const SDL_BlendMode &blend_mode) {
-        addCommand<RenderCommand::BlendModeCMD>(_renderer, blend_mode);
+    void Renderer::drawCachedText(TTF_Font* font, std::string_view text, const Vector2& position,
+                                  const SDL_Color& color) {
+        if (_recording) {
+            Logger::log("Renderer: Cached texts can't be recorded into a render list!", Logger::Warn);
+            return;
+        }
+        Size size;
+        auto entry = _text_cache.acquire(font, text, color, _frame_index, size);
+        if (!entry) return;
+        /// A text drawn for the first time isn't rendered yet, so its size is unknown.
+        if (size.width > 0 && !visible({position.x, position.y, size.width, size.height})) return;
+        addCommand(RenderCommand::CachedTextCMD{&_text_cache, entry, position});
+    }
+
+    RenderCommand::TextCache& Renderer::textCache() {
+        return _text_cache;
+    }
+
+    uint64_t Renderer::frameIndex() const {
+        return _frame_index;
+    }
+
+    RenderCommand::TextureLoader& Renderer::textureLoader() {
+        return _texture_loader;
+    }
+
+    void Renderer::setTextureUploadBudget(uint64_t microseconds, size_t bytes) {
+        _texture_loader.setBudget(microseconds, bytes);
+    }
+
+    void Renderer::releaseTexture(SDL_Texture* texture) {
+        if (!texture) return;
+        std::lock_guard lock(_released_mutex);
+        _released_textures.push_back({texture, _frame_index});
+    }
+
+    void Renderer::destroyReleasedTextures(uint64_t rendered) {
+        std::lock_guard lock(_released_mutex);
+        /// Released in frame order, so the ones still in use are all at the back.
+        while (!_released_textures.empty() && _released_textures.front().second <= rendered) {
+            SDL_DestroyTexture(_released_textures.front().first);
+            _released_textures.pop_front();
+        }
+    }
+
+    uint64_t Renderer::hashFramePixels() const {
+        /// FNV-1a over the visible bytes of every row.
+        uint64_t hash = 0xcbf29ce484222325ull;
+        auto surface = SDL_RenderReadPixels(_renderer, nullptr);
+        if (!surface) {
+            Logger::log(std::format("Renderer: Read pixels failed! Exception: {}", SDL_GetError()), Logger::Warn);
+            return 0;
+        }
+        const size_t ROW_BYTES = static_cast<size_t>(surface->w) * SDL_BYTESPERPIXEL(surface->format);
+        auto pixels = static_cast<const uint8_t*>(surface->pixels);
+        for (int y = 0; y < surface->h; ++y) {
+            auto row = pixels + static_cast<size_t>(y) * surface->pitch;
+            for (size_t x = 0; x < ROW_BYTES; ++x) {
+                hash = (hash ^ row[x]) * 0x100000001b3ull;
+            }
+        }
+        SDL_DestroySurface(surface);
+        return hash;
+    }
+
+    void CommandRecorder::drawLayer(RenderLayer* layer) {
+        if (!layer) return;
+        addCommand(RenderCommand::LayerCMD{layer});
     }
 
     Window::Window(Engine* object, const std::string& title, int width, int height,  GraphicEngine engine)
         : _title(title), _window_geometry(0, 0, width, height), _visible(true), _resizable(false), _engine(object) {
-        if (engine == VULKAN)
+        if (Engine::headless())
+            _window = SDL_CreateWindow(_title.c_str(), width, height, SDL_WINDOW_HIDDEN);
+        else if (engine == VULKAN)
             _window = SDL_CreateWindow(_title.c_str(), width, height, SDL_WINDOW_VULKAN);
         else
             _window = SDL_CreateWindow(_title.c_str(), width, height, SDL_WINDOW_OPENGL);
@@ -623,8 +1396,17 @@ namespace MyEngine {
             std::cout << std::format("=== Application Info ===\nID: {} \nName: {} \nVersion: {} \n",
                                      app_id, app_name, app_version) << std::endl;
         }
+        if (_headless) {
+            SDL_SetHint(SDL_HINT_VIDEO_DRIVER, "offscreen");
+            SDL_SetHint(SDL_HINT_AUDIO_DRIVER, "dummy");
+        }
         if (!SDL_Init(SDL_INIT_AUDIO | SDL_INIT_VIDEO | SDL_INIT_EVENTS)) {
-            throwFatalError();
+            if (!_headless) throwFatalError();
+            /// Older SDL builds may lack the offscreen driver.
+            SDL_SetHint(SDL_HINT_VIDEO_DRIVER, "dummy");
+            if (!SDL_Init(SDL_INIT_AUDIO | SDL_INIT_VIDEO | SDL_INIT_EVENTS)) {
+                throwFatalError();
+            }
         }
         SDL_SetAppMetadata(app_name.c_str(), app_version.c_str(), app_id.c_str());
         Logger::log("Engine: Started up application!");
@@ -643,6 +1425,14 @@ namespace MyEngine {
         _show_app_info = false;
     }
 
+    void Engine::setHeadless(bool headless) {
+        _headless = headless;
+    }
+
+    bool Engine::headless() {
+        return _headless;
+    }
+
     void Engine::setApplicationID(std::string &&app_id) {
         _app_id = std::move(app_id);
         SDL_SetAppMetadata(_app_name.c_str(), _app_version.c_str(), _app_id.c_str());
@@ -692,6 +1482,39 @@ namespace MyEngine {
         return _return_code;
     }
 
+    Engine::BenchmarkResult Engine::benchmark(uint32_t frames, bool hash_frames) {
+        BenchmarkResult result;
+        result.frame_times.reserve(frames);
+        if (hash_frames) result.frame_hashes.reserve(frames);
+        for (auto& win : _window_list) {
+            win.second->renderer()->setFrameHashEnabled(hash_frames);
+        }
+        const uint64_t FREQUENCY = SDL_GetPerformanceFrequency();
+        for (uint32_t i = 0; i < frames && _running && !_quit_requested; ++i) {
+            const uint64_t START = SDL_GetPerformanceCounter();
+            _running = EventSystem::global(this)->run();
+            if (!_running) break;
+            for (auto& win : _window_list) {
+                win.second->renderer()->_update();
+            }
+            const double ELAPSED = static_cast<double>(SDL_GetPerformanceCounter() - START) * 1000.0 /
+                                   static_cast<double>(FREQUENCY);
+            result.frame_times.push_back(ELAPSED);
+            result.total_time += ELAPSED;
+            if (hash_frames) {
+                auto main_window = window(_main_window_id);
+                result.frame_hashes.push_back(main_window ? main_window->renderer()->frameHash() : 0);
+            }
+        }
+        for (auto& win : _window_list) {
+            win.second->renderer()->setFrameHashEnabled(false);
+        }
+        Logger::log(std::format("Engine: Benchmark finished: {} frames, avg {:.3f} ms, min {:.3f} ms, max {:.3f} ms",
+                                result.frame_times.size(), result.average(), result.min(), result.max()),
+                    Logger::Info);
+        return result;
+    }
+
     void Engine::newWindow(Window* window) {
         if (!window) return;
         if (_main_window_id == 0) _main_window_id = window->windowID();
@@ -854,6 +1677,7 @@ namespace MyEngine {
     void TextSystem::unload() {
         std::for_each(_text_map.begin(), _text_map.end(), [](auto& text) {
             TTF_DestroyText(text.second.self);
+            dropImage(text.second);
         });
         std::for_each(_font_map.begin(), _font_map.end(), [](auto& font) {
             TTF_DestroyRendererTextEngine(font.second.engine);
@@ -864,7 +1688,8 @@ namespace MyEngine {
         Logger::log("TextSystem: Unloaded text system");
     }
 
-    bool TextSystem::addFont(const std::string& font_name, const std::string& font_path, Renderer* renderer) {
+    bool TextSystem::addFont(const std::string& font_name, const std::string& font_path, Renderer* renderer,
+                             bool sdf) {
         if (_font_map.contains(font_name)) {
             Logger::log(std::format("Font '{}' is already added!", font_name), Logger::Error);
             return false;
@@ -875,7 +1700,7 @@ namespace MyEngine {
         }
         _font_map.emplace(font_name, 
                 FontEngine{TTF_CreateRendererTextEngine(renderer->self()), TTF_CreateSurfaceTextEngine(),
-                std::make_unique<Font>(font_path, 12.0f)});
+                std::make_unique<Font>(font_path, sdf ? SDF_FONT_SIZE : 12.0f), renderer});
         auto& new_font = _font_map.at(font_name);
         if (!new_font.font->self()) {
             TTF_DestroyRendererTextEngine(new_font.engine);
@@ -884,6 +1709,7 @@ namespace MyEngine {
             Logger::log(std::format("Can't load font '{}'! Exception: {}", font_name, SDL_GetError()), Logger::Error);
             return false;
         }
+        if (sdf) new_font.font->setSDF(true);
         return true;
     }
 
@@ -892,8 +1718,13 @@ namespace MyEngine {
             Logger::log(std::format("Font '{}' is not in the font list!", font_name), Logger::Error);
             return false;
         }
-        TTF_DestroyRendererTextEngine(_font_map[font_name].engine);
-        TTF_DestroySurfaceTextEngine(_font_map[font_name].surface_engine);
+        auto& engine = _font_map[font_name];
+        if (engine.renderer) {
+            if (engine.renderer->glyphAtlas()) engine.renderer->glyphAtlas()->removeFont(engine.font->self());
+            engine.renderer->textCache().removeFont(engine.font->self());
+        }
+        TTF_DestroyRendererTextEngine(engine.engine);
+        TTF_DestroySurfaceTextEngine(engine.surface_engine);
         _font_map.erase(font_name);
         return true;
     }
@@ -935,6 +1766,7 @@ namespace MyEngine {
             Logger::log(std::format("Text ID {} is not in the text list!", text_id), Logger::Error);
             return false;
         }
+        dropImage(_text_map[text_id]);
         _text_map.erase(text_id);
         return true;
     }
@@ -951,6 +1783,7 @@ namespace MyEngine {
             return false;
         }
         m_text.text = text;
+        dropImage(m_text);
         return true;
     }
 
@@ -966,6 +1799,7 @@ namespace MyEngine {
             return false;
         }
         m_text.text += text;
+        dropImage(m_text);
         return true;
     }
 
@@ -986,6 +1820,7 @@ namespace MyEngine {
             return false;
         }
         m_text.font_name = font_name;
+        dropImage(m_text);
         return true;
     }
 
@@ -1002,6 +1837,7 @@ namespace MyEngine {
             return false;
         }
         m_text.font_color = color;
+        dropImage(m_text);
         return true;
     }
 
@@ -1035,29 +1871,94 @@ namespace MyEngine {
         return true;
     }
 
+    bool TextSystem::drawCachedText(uint64_t text_id, const Vector2& pos, Renderer* renderer) {
+        if (!renderer) {
+            Logger::log("The specified renderer is not valid!", Logger::Error);
+            return false;
+        }
+        if (!_text_map.contains(text_id)) {
+            Logger::log(std::format("Text ID {} is not in the text list!", text_id), Logger::Error);
+            return false;
+        }
+        auto& text = _text_map[text_id];
+        if (!_font_map.contains(text.font_name)) {
+            Logger::log(std::format("Text ID {} has not set the font! Try to use `setTextFont()` at first!", text_id), Logger::Error);
+            return false;
+        }
+        renderer->drawCachedText(_font_map[text.font_name].font->self(), text.text, pos, text.font_color);
+        return true;
+    }
+
+    bool TextSystem::drawNumber(const std::string& font_name, int64_t value, const Vector2& pos,
+                                Renderer* renderer, const SDL_Color& color) {
+        if (!renderer) {
+            Logger::log("The specified renderer is not valid!", Logger::Error);
+            return false;
+        }
+        auto it = _font_map.find(font_name);
+        if (it == _font_map.end()) {
+            Logger::log(std::format("Font '{}' is not in the font list!", font_name), Logger::Error);
+            return false;
+        }
+        renderer->drawNumber(it->second.font->self(), value, pos, color);
+        return true;
+    }
+
+    bool TextSystem::drawFixed(const std::string& font_name, double value, uint8_t decimals, const Vector2& pos,
+                               Renderer* renderer, const SDL_Color& color) {
+        if (!renderer) {
+            Logger::log("The specified renderer is not valid!", Logger::Error);
+            return false;
+        }
+        auto it = _font_map.find(font_name);
+        if (it == _font_map.end()) {
+            Logger::log(std::format("Font '{}' is not in the font list!", font_name), Logger::Error);
+            return false;
+        }
+        renderer->drawFixed(it->second.font->self(), value, decimals, pos, color);
+        return true;
+    }
+
+    void TextSystem::dropImage(Text& text) {
+        if (text.image) SDL_DestroySurface(text.image);
+        text.image = nullptr;
+    }
+
     SDL_Surface* TextSystem::toImage(uint64_t text_id) {
         if (!_text_map.contains(text_id)) {
             Logger::log(std::format("Text ID {} is not in the text list!", text_id), Logger::Error);
             return nullptr;
         }
-        if (!_font_map.contains(_text_map[text_id].font_name)) {
+        auto& m_text = _text_map[text_id];
+        if (!_font_map.contains(m_text.font_name)) {
             Logger::log(std::format("Text ID {} has not set the font! Try to use `setTextFont()` at first!", text_id), Logger::Error);
             return nullptr;
         }
-        auto& font_engine = _font_map[_text_map[text_id].font_name];
-        auto& text =  _text_map[text_id].text;
-        TTF_Text* temp_text = TTF_CreateText(font_engine.surface_engine, font_engine.font->self(), text.c_str(), text.size());
-        auto t_surface = font_engine.font->toImage(text);
-        SDL_Surface* surface = SDL_CreateSurface(t_surface->w, t_surface->h, SDL_PIXELFORMAT_ABGR64);
-        SDL_DestroySurface(t_surface);
-        auto _ret = TTF_DrawSurfaceText(temp_text, 0, 0, surface);
-        if (!_ret) {
-            Logger::log(std::format("Text to image failed! Exception: {}", SDL_GetError()), Logger::Error);
+        auto& font_engine = _font_map[m_text.font_name];
+        /// Resizing or restyling the font changes its generation.
+        const uint32_t GENERATION = TTF_GetFontGeneration(font_engine.font->self());
+        if (m_text.image && m_text.image_generation != GENERATION) dropImage(m_text);
+        if (!m_text.image) {
+            auto& text = m_text.text;
+            TTF_Text* temp_text = TTF_CreateText(font_engine.surface_engine, font_engine.font->self(), text.c_str(), text.size());
+            int width = 0, height = 0;
+            if (!temp_text || !TTF_GetTextSize(temp_text, &width, &height) || !width || !height) {
+                Logger::log(std::format("Text to image failed! Exception: {}", SDL_GetError()), Logger::Error);
+                if (temp_text) TTF_DestroyText(temp_text);
+                return nullptr;
+            }
+            SDL_Surface* surface = SDL_CreateSurface(width, height, SDL_PIXELFORMAT_ABGR64);
+            auto _ret = surface && TTF_DrawSurfaceText(temp_text, 0, 0, surface);
             TTF_DestroyText(temp_text);
-            return nullptr;
+            if (!_ret) {
+                Logger::log(std::format("Text to image failed! Exception: {}", SDL_GetError()), Logger::Error);
+                if (surface) SDL_DestroySurface(surface);
+                return nullptr;
+            }
+            m_text.image = surface;
+            m_text.image_generation = GENERATION;
         }
-        TTF_DestroyText(temp_text);
-        return surface;
+        return SDL_DuplicateSurface(m_text.image);
     }
 
     AudioSystem* AudioSystem::global() {
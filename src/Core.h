@@ -5,6 +5,11 @@
 
 #include "Basic.h"
 #include "Components.h"
+#include "Renderer/RenderList.h"
+#include "Renderer/FrameStats.h"
+#include "Renderer/GlyphAtlas.h"
+#include "Renderer/TextCache.h"
+#include "Renderer/TextureLoader.h"
 
 namespace MyEngine {
     class EngineException : public std::exception {
@@ -19,61 +24,287 @@ namespace MyEngine {
 
     class Engine;
     class Window;
+    class Renderer;
     struct TextureProperty;
     class Texture;
+    class RenderLayer;
     class EventSystem;
     
     namespace RenderCommand {
         class BaseCommand;
         class CommandFactory;
     }
-
-    class Renderer {
-    private:
-        std::deque<std::unique_ptr<RenderCommand::BaseCommand>> _cmd_list;
+    using RenderCommand::RenderList;
+    using RenderCommand::FrameStats;
+
+    /// Records draw calls into a command buffer for a `Renderer` to execute.
+    /// The `Renderer` itself is the recorder of the thread running `paintEvent`; further
+    /// recorders from `Renderer::recorder()` can be filled by worker threads in parallel.
+    /// A recorder must only be used by one thread at a time.
+    class CommandRecorder {
+        friend class Renderer;
+    protected:
+        /// Two frames can be in flight when the renderer is pipelined.
+        RenderCommand::CommandBuffer _cmd_buffers[2];
+        RenderCommand::CommandBuffer* _cmd_buffer{&_cmd_buffers[0]};
+        /// Where new commands go: the frame, or the list being recorded.
+        RenderCommand::CommandBuffer* _target{_cmd_buffer};
+        RenderList* _recording{nullptr};
+        SDL_BlendMode _record_blend_mode{SDL_BLENDMODE_NONE};
+        bool _record_sort_pending{false};
+        int16_t _record_layer{0};
+        /// The visible area as of the commands submitted so far, in draw coordinates.
+        SDL_Rect _cull_viewport{}, _cull_clip{};
+        SDL_FRect _cull_rect{};
+        bool _cull_viewport_set{false}, _cull_clip_set{false}, _cull_bounded{false};
+        bool _culling_enabled{true}, _cull_scaled{false};
+        /// Which of the viewport and clip the commands of this frame change, so the
+        /// pipeline knows where the frame in flight leaves them without asking SDL.
+        enum CullChange : uint8_t {
+            ViewportChanged = 0x1,
+            ClipChanged = 0x2,
+            ViewUnknown = 0x4
+        };
+        uint8_t _cull_changes{0};
+        uint64_t _culled_count{0};
         SDL_Renderer* _renderer{nullptr};
-        Window* _window{nullptr};
-        static SDL_Color _background_color;
-
-        template<typename T, typename ...Args>
-        void addCommand(Args... args);
+        SDL_BlendMode _blend_mode{SDL_BLENDMODE_NONE};
+        bool _sort_enabled{false}, _sort_pending{false}, _layered{false};
+        int16_t _layer{0};
+        uint32_t _segment{0};
+        FrameStats _stats_current;
+        bool _stats_enabled{false};
+        /// Turn shape and texture draws into vertex data right away, for frames that are
+        /// executed while the drawn objects may already change.
+        bool _snapshot{false};
+        RenderCommand::GeometryBatch _snapshot_batch;
+        /// Set while the renderer's glyph atlas is enabled; texts are then drawn as quads.
+        RenderCommand::GlyphAtlas* _glyph_atlas{nullptr};
+
+        template<typename T>
+        void addCommand(const T& command);
+        void pushSnapshot(uint8_t flags, uint64_t sort_key);
+        Vector2* const* copyPositions(std::span<Vector2* const> positions);
+        /// Start recording into the other command buffer.
+        void swapBuffers();
+        [[nodiscard]] RenderCommand::CommandBuffer& backBuffer();
+        uint64_t nextSortKey(uint8_t flags, uint32_t state);
+        void updateCullRect();
+        bool visible(const SDL_FRect& bounds);
+        template<typename T>
+        T** visibleItems(std::span<T* const> items, uint32_t& count);
+        /// Checks that every per-shape array holds one entry per shape or one for all.
+        bool instanceArrays(const char* function, size_t count, std::initializer_list<size_t> sizes);
+        /// Copies `data` into the command buffer, keeping only the `visible` entries unless
+        /// it has a single entry shared by all shapes.
+        template<typename T>
+        const T* copyInstances(std::span<const T> data, std::span<const uint32_t> visible);
+        void drawInstances(RenderCommand::InstancesCMD command, std::span<const SDL_FRect> bounds,
+                           std::span<const Vector2> positions, std::span<const Vector2> ends,
+                           std::span<const Size> sizes, std::span<const float> values,
+                           std::span<const float> rotations, std::span<const SDL_Color> colors);
+        /// Draws `text` through the glyph atlas if it is enabled and the text isn't wrapped.
+        bool drawAtlasText(TTF_Text* text, const Vector2& position);
+        /// Take over the render settings and culling state of `other`.
+        void inherit(const CommandRecorder& other);
+        /// Forget the submitted commands' layer, segment and sort state.
+        void resetFrameState();
     public:
-        explicit Renderer(Window* window = nullptr);
-        ~Renderer();
-        [[nodiscard]] SDL_Renderer* self() const;
-        [[nodiscard]] Window* window() const;
-        void _update();
+        explicit CommandRecorder(SDL_Renderer* renderer = nullptr);
+        virtual ~CommandRecorder();
+        CommandRecorder(const CommandRecorder&) = delete;
+        CommandRecorder& operator=(const CommandRecorder&) = delete;
+
         void fillBackground(const SDL_Color& color);
         void fillBackground(SDL_Color&& color);
         void fillBackground(uint64_t rgb_hex = 0);
         void drawPoint(Graphics::Point* point);
-        void drawPoints(const std::vector<Graphics::Point*>& point_list);
+        void drawPoints(std::span<Graphics::Point* const> point_list);
         void drawLine(Graphics::Line* line);
-        void drawLines(const std::vector<Graphics::Line*>& line_list);
+        void drawLines(std::span<Graphics::Line* const> line_list);
         void drawRectangle(Graphics::Rectangle* rectangle);
-        void drawRectangles(const std::vector<Graphics::Rectangle*>& rectangle_list);
+        void drawRectangles(std::span<Graphics::Rectangle* const> rectangle_list);
         void drawTriangle(Graphics::Triangle* triangle);
-        void drawTriangles(const std::vector<Graphics::Triangle*>& triangle);
+        void drawTriangles(std::span<Graphics::Triangle* const> triangle_list);
         void drawEllipse(Graphics::Ellipse* ellipse);
-        void drawEllipses(const std::vector<Graphics::Ellipse*>& ellipse);
+        void drawEllipses(std::span<Graphics::Ellipse* const> ellipse_list);
+        /// Instanced shapes, drawn straight from arrays without a `Graphics` object each.
+        /// The arrays are copied, so they can change once the call returns. Every array
+        /// but the positions may hold one entry per shape or a single one for all of them.
+        void drawCircles(std::span<const Vector2> centers, std::span<const float> radii,
+                         std::span<const SDL_Color> colors, uint16_t segment = 0);
+        void drawRects(std::span<const Vector2> positions, std::span<const Size> sizes,
+                       std::span<const SDL_Color> colors, std::span<const float> rotations = {});
+        void drawLines(std::span<const Vector2> starts, std::span<const Vector2> ends,
+                       std::span<const float> thickness, std::span<const SDL_Color> colors);
         void drawTexture(SDL_Texture* texture, TextureProperty* property);
-        void drawTexture(SDL_Texture* texture, const std::vector<TextureProperty*>& property);
-        void drawTextures(const std::vector<SDL_Texture*>& textures, const std::vector<TextureProperty*>& properties);
+        void drawTexture(SDL_Texture* texture, std::span<TextureProperty* const> properties);
+        void drawTextures(std::span<SDL_Texture* const> textures, std::span<TextureProperty* const> properties);
 
         void drawText(TTF_Text* text, Vector2& position);
-        void drawTexts(TTF_Text* text, const std::vector<Vector2*>& position_list);
-        void drawTexts(const std::vector<TTF_Text*>& text_list, const std::vector<Vector2*>& position_list);
+        void drawTexts(TTF_Text* text, std::span<Vector2* const> position_list);
+        void drawTexts(std::span<TTF_Text* const> text_list, std::span<Vector2* const> position_list);
+        /// Draws `text` through the renderer's glyph atlas, so consecutive texts batch
+        /// into a single draw call. Requires `Renderer::setGlyphAtlasEnabled(true)`.
+        /// A `size` other than 0 scales the glyphs to that point size, which stays sharp
+        /// for SDF fonts.
+        void drawGlyphText(TTF_Font* font, std::string_view text, const Vector2& position,
+                           const SDL_Color& color = StdColor::White, float size = 0);
+        /// Draws `value` from digit glyphs the glyph atlas keeps per font. Nothing is
+        /// formatted or shaped until the frame is rendered, and no string is allocated.
+        void drawNumber(TTF_Font* font, int64_t value, const Vector2& position,
+                        const SDL_Color& color = StdColor::White, float size = 0);
+        /// Like `drawNumber()`, with `decimals` digits after the point (at most 15). NaN and
+        /// infinities are drawn as "nan", "inf" and "-inf".
+        void drawFixed(TTF_Font* font, double value, uint8_t decimals, const Vector2& position,
+                       const SDL_Color& color = StdColor::White, float size = 0);
         void drawDebugText(const std::string& text, const Vector2& position,
                            const SDL_Color& color = StdColor::White);
-        void drawDebugTexts(const StringList& text_list, const std::vector<Vector2*>& position_list,
+        void drawDebugTexts(std::span<const std::string> text_list, std::span<Vector2* const> position_list,
                            const SDL_Color& color = StdColor::White);
-        void drawDebugFPS(const Vector2& position = {20, 20}, const SDL_Color& color = StdColor::White);
         void setViewport(const Geometry& geometry);
         void setClipView(const Geometry& geometry);
         void setBlendMode(const SDL_BlendMode& blend_mode);
+        /// When enabled, shape and texture draws submitted afterwards may be reordered by
+        /// blend mode, texture and primitive so more of them share a batch. Any other
+        /// command, or draws submitted while disabled, keep their painter's order.
+        void setSortEnabled(bool enabled);
+        [[nodiscard]] bool sortEnabled() const;
+        /// Draws of a lower layer are rendered before those of a higher one, whatever
+        /// order they were submitted in; within a layer the submission order is kept.
+        /// State changes (viewport, clip view, blend mode) stay in order with the draws
+        /// of their own layer. The layer goes back to 0 at the start of every frame.
+        void setLayer(int16_t layer);
+        [[nodiscard]] int16_t layer() const;
+        /// Draw calls between `beginRecord()` and `endRecord()` are stored in `list`
+        /// instead of the current frame. Recording replaces the previous content.
+        void beginRecord(RenderList* list);
+        void endRecord();
+        [[nodiscard]] bool recording() const;
+        void drawRenderList(RenderList* list);
+        void drawLayer(RenderLayer* layer);
+        /// Skip shapes and textures outside the current viewport and clip rect when they
+        /// are submitted. Draws recorded into a render list are never culled.
+        void setCullingEnabled(bool enabled);
+        [[nodiscard]] bool cullingEnabled() const;
 
         template<typename T, typename ...Args>
-        void addCustomCommand(Args... args);
+        void addCustomCommand(Args&&... args);
+    };
+
+    class Renderer : public CommandRecorder {
+    private:
+        RenderCommand::GeometryBatch _geometry_batch;
+        RenderCommand::StateCache _state_cache;
+        RenderCommand::RenderContext _context;
+        std::unique_ptr<RenderCommand::GlyphAtlas> _glyphs;
+        RenderCommand::TextCache _text_cache;
+        RenderCommand::TextureLoader _texture_loader;
+        /// Textures waiting for the frame they were released in to be rendered.
+        std::deque<std::pair<SDL_Texture*, uint64_t>> _released_textures;
+        std::mutex _released_mutex;
+        /// Index of the frame being recorded.
+        uint64_t _frame_index{0};
+        /// Recorders for other threads, merged after the own commands in slot order.
+        std::vector<std::unique_ptr<CommandRecorder>> _recorders;
+        std::vector<bool> _recorders_bound;
+        static constexpr uint32_t PIPELINE_IDLE = 0, PIPELINE_PAINTING = 1, PIPELINE_STOPPING = 2;
+        /// Runs `paintEvent` of the next frame while the current one is rendered.
+        std::thread _pipeline;
+        std::atomic<uint32_t> _pipeline_state{PIPELINE_IDLE};
+        /// Whether the frame being recorded copies its draws, so it can be pipelined.
+        bool _frame_snapshot{false};
+        uint64_t _last_culled_count{0};
+        Window* _window{nullptr};
+        static SDL_Color _background_color;
+        /// Written while rendering, which may overlap a pipelined `paintEvent`.
+        std::atomic<uint64_t> _frame_hash{0};
+        bool _frame_hash_enabled{false};
+        RenderCommand::DrawCounters _draw_counters;
+        FrameStats _stats;
+        std::deque<FrameStats> _stats_history;
+        size_t _stats_history_size{0};
+        uint64_t _stats_frame{0}, _pool_hits_mark{0}, _pool_misses_mark{0};
+
+        /// `in_flight` is set when the frame just recorded hasn't been rendered yet.
+        void resetCullState(bool in_flight = false);
+        void mergeRecorders();
+        void renderFrame(RenderCommand::CommandBuffer& frame, FrameStats& stats);
+        /// Makes `stats` the last completed frame's; only while no `paintEvent` runs.
+        void publishFrameStats(FrameStats& stats);
+        void destroyReleasedTextures(uint64_t rendered);
+        void clearFrame(bool back_buffers);
+        void pipelineLoop();
+        uint64_t hashFramePixels() const;
+        void finishFrameStats(FrameStats& stats, uint64_t start, uint64_t executed, uint64_t presented);
+    public:
+        explicit Renderer(Window* window = nullptr);
+        ~Renderer() override;
+        [[nodiscard]] SDL_Renderer* self() const;
+        [[nodiscard]] Window* window() const;
+        void _update();
+        void drawDebugFPS(const Vector2& position = {20, 20}, const SDL_Color& color = StdColor::White);
+        /// A recorder that another thread can fill with draw calls for this frame.
+        /// Its commands are drawn after the renderer's own, ordered by layer first and
+        /// then by slot, so the result doesn't depend on which thread finishes first.
+        /// The first call of a frame hands over the current blend mode, layer, sort and
+        /// culling settings; the render state itself does not carry over between slots.
+        /// Call it from the thread running `paintEvent`, and make sure every thread is
+        /// done recording before `paintEvent` returns.
+        [[nodiscard]] CommandRecorder* recorder(uint8_t slot);
+        /// Run `paintEvent` on a separate thread, building the next frame while this one
+        /// is executed and presented. Event handling still happens between the frames,
+        /// never while `paintEvent` runs. Shapes and sprites are copied when they are
+        /// drawn; texts, render lists, layers and custom commands are still used by
+        /// reference and must not change until the frame after the one they were drawn in.
+        ///
+        /// `paintEvent` then runs while the renderer is busy with the previous frame, so it
+        /// must not call into SDL_Renderer itself. The draw and state calls of the
+        /// recorders, `RenderLayer::draw`, `drawGlyphText`, `drawNumber`, `drawCachedText`
+        /// and `Texture::setImagePathAsync` are safe, as they leave everything that touches
+        /// the renderer to the frame's execution. Creating or reloading textures synchronously
+        /// (the `Texture` constructors, `setImagePath`, `setImageFromSurface`), adding fonts
+        /// and texts, or drawing a `Texture` the same frame it is destroyed are not.
+        /// `frameStats`, `frameStatsHistory`, `culledCount` and `frameHash` may be read from
+        /// it, while `setFrameStatsEnabled` may not be called from it.
+        void setPipelineEnabled(bool enabled);
+        [[nodiscard]] bool pipelineEnabled() const;
+        /// Number of draws culled in the last completed frame.
+        [[nodiscard]] uint64_t culledCount() const;
+        /// Hash the pixels of every rendered frame, for comparing output between runs.
+        void setFrameHashEnabled(bool enabled);
+        [[nodiscard]] uint64_t frameHash() const;
+        /// Collect a `FrameStats` for every frame and keep the last `history_size` of them.
+        /// With the pipeline on, don't call it from `paintEvent`.
+        void setFrameStatsEnabled(bool enabled, size_t history_size = 0);
+        [[nodiscard]] bool frameStatsEnabled() const;
+        /// Statistics of the last completed frame. They are only updated between two
+        /// `paintEvent` calls, so a pipelined `paintEvent` may read them too.
+        [[nodiscard]] const FrameStats& frameStats() const;
+        [[nodiscard]] const std::deque<FrameStats>& frameStatsHistory() const;
+        /// Draw texts from glyphs packed into shared textures instead of one texture per
+        /// text, batching them with each other and with shapes. Wrapped texts still take
+        /// the regular path. The atlas is kept when disabled, until the renderer is gone.
+        void setGlyphAtlasEnabled(bool enabled);
+        [[nodiscard]] bool glyphAtlasEnabled() const;
+        /// The glyph atlas, or nullptr if it was never enabled.
+        [[nodiscard]] RenderCommand::GlyphAtlas* glyphAtlas() const;
+        /// Draws `text` from a texture kept in `textCache()`, rendering it only the first
+        /// time. Meant for labels that are drawn every frame; it can't be recorded into a
+        /// render list, as the texture may be dropped once it is no longer drawn.
+        void drawCachedText(TTF_Font* font, std::string_view text, const Vector2& position,
+                            const SDL_Color& color = StdColor::White);
+        [[nodiscard]] RenderCommand::TextCache& textCache();
+        /// Number of frames recorded before the current one.
+        [[nodiscard]] uint64_t frameIndex() const;
+        /// Decodes images for `Texture::setImagePathAsync()`. Decoded images are uploaded
+        /// after each frame is rendered, before the next `paintEvent` runs.
+        [[nodiscard]] RenderCommand::TextureLoader& textureLoader();
+        /// Time in microseconds and bytes of image data uploaded per frame at most.
+        void setTextureUploadBudget(uint64_t microseconds, size_t bytes);
+        /// Destroys `texture` once the frame being recorded now is rendered, for textures
+        /// that recorded commands may still draw.
+        void releaseTexture(SDL_Texture* texture);
     };
 
     class Window {
@@ -210,6 +441,30 @@ namespace MyEngine {
                         std::string&& app_id = "HelloWorld.app");
         ~Engine();
         static void disabledShowAppInfo();
+        /// Run without a display: offscreen video driver, dummy audio, hidden windows and
+        /// the software renderer. Has to be set before the engine is created.
+        static void setHeadless(bool headless);
+        static bool headless();
+
+        struct BenchmarkResult {
+            /// In milliseconds, one entry per frame.
+            std::vector<double> frame_times;
+            /// Pixel hash of the main window per frame; empty unless requested.
+            std::vector<uint64_t> frame_hashes;
+            double total_time{0};
+
+            [[nodiscard]] double average() const {
+                return frame_times.empty() ? 0 : total_time / static_cast<double>(frame_times.size());
+            }
+            [[nodiscard]] double min() const {
+                return frame_times.empty() ? 0 : *std::min_element(frame_times.begin(), frame_times.end());
+            }
+            [[nodiscard]] double max() const {
+                return frame_times.empty() ? 0 : *std::max_element(frame_times.begin(), frame_times.end());
+            }
+        };
+        /// Render `frames` frames as fast as possible, ignoring the FPS limit.
+        BenchmarkResult benchmark(uint32_t frames, bool hash_frames = false);
 
         void setApplicationID(const std::string& app_id);
         void setApplicationID(std::string&& app_id);
@@ -257,6 +512,7 @@ namespace MyEngine {
         uint32_t _real_fps{0};
         static SDL_WindowID _main_window_id;
         static bool _show_app_info;
+        static bool _headless;
         std::unordered_map<SDL_WindowID, std::unique_ptr<Window>> _window_list;
         std::function<void()> _clean_up_event;
         std::string _app_name, _app_id, _app_version;
@@ -270,11 +526,15 @@ namespace MyEngine {
             std::string text;
             std::string font_name;
             SDL_Color font_color{StdColor::Black};
+            /// Kept by `toImage()` until the text, its font or its color changes.
+            SDL_Surface* image{nullptr};
+            uint32_t image_generation{0};
         };
         struct FontEngine {
             TTF_TextEngine* engine;
             TTF_TextEngine* surface_engine;
             std::shared_ptr<Font> font;
+            Renderer* renderer{nullptr};
         };
         TextSystem(TextSystem &&) = delete;
         TextSystem(const TextSystem &) = delete;
@@ -285,7 +545,10 @@ namespace MyEngine {
         static TextSystem* global();
         bool isLoaded() const;
         void unload();
-        bool addFont(const std::string& font_name, const std::string& font_path, Renderer* renderer);
+        /// Glyphs of SDF fonts are rasterized once at this size and scaled from there.
+        static constexpr float SDF_FONT_SIZE = 48.f;
+        bool addFont(const std::string& font_name, const std::string& font_path, Renderer* renderer,
+                     bool sdf = false);
         bool removeFont(const std::string& font_name);
         Font* font(const std::string& font_name);
         StringList fontNameList() const;
@@ -299,9 +562,20 @@ namespace MyEngine {
         Text* indexOfText(uint64_t text_id);
         std::vector<uint64_t> textIDList() const;
         bool drawText(uint64_t text_id, const Vector2& pos, Renderer* renderer);
+        /// Like `drawText()`, but draws a texture from the renderer's text cache instead of
+        /// laying out and rasterizing the text again.
+        bool drawCachedText(uint64_t text_id, const Vector2& pos, Renderer* renderer);
+        /// Draw numbers for counters and scores without going through a `Text`. They need
+        /// the renderer's glyph atlas to be enabled.
+        bool drawNumber(const std::string& font_name, int64_t value, const Vector2& pos, Renderer* renderer,
+                        const SDL_Color& color = StdColor::Black);
+        bool drawFixed(const std::string& font_name, double value, uint8_t decimals, const Vector2& pos,
+                       Renderer* renderer, const SDL_Color& color = StdColor::Black);
+        /// A copy of the text rendered to a surface, which the caller has to destroy.
         SDL_Surface* toImage(uint64_t text_id);
     private:
         explicit TextSystem();
+        static void dropImage(Text& text);
         static std::unique_ptr<TextSystem> _instance;
         bool _is_loaded{false};
         std::map<uint64_t, Text> _text_map;
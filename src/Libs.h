@@ -9,10 +9,14 @@
 #include <fstream>
 #include <sstream>
 #include <format>
+#include <charconv>
 #include <string>
+#include <cstring>
+#include <cmath>
 #include <variant>
 #include <vector>
 #include <array>
+#include <span>
 #include <deque>
 #include <list>
 #include <queue>
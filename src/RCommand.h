@@ -4,15 +4,46 @@
 #include "Renderer/CommandFactory.h"
 
 namespace MyEngine {
-    template<typename T, typename ...Args>
-    void Renderer::addCommand(Args... args) {
-        auto ptr = RenderCommand::CommandFactory::acquire<T>(args...);
-        if (ptr) _cmd_list.push_back(std::unique_ptr<T>(ptr));
+    template<typename T>
+    void CommandRecorder::addCommand(const T& command) {
+        using RenderCommand::CommandHeader;
+        uint8_t flags = 0;
+        uint32_t state = 0;
+        if constexpr (T::BATCHABLE) {
+            flags |= CommandHeader::Batchable;
+            if (_sort_enabled) {
+                flags |= CommandHeader::Sortable;
+                state = RenderCommand::packStateKey(_blend_mode, command.batchTexture(), T::TYPE);
+            }
+        }
+        if (_stats_enabled && !_recording) ++_stats_current.commands[static_cast<size_t>(T::TYPE)];
+        if constexpr (T::BATCHABLE && !RenderCommand::SELF_CONTAINED<T>) {
+            if (_snapshot && !_recording) {
+                command.exec({_renderer, &_snapshot_batch, nullptr, true, nullptr});
+                pushSnapshot(flags, nextSortKey(flags, state));
+                return;
+            }
+        }
+        _target->push(command, flags, nextSortKey(flags, state));
     }
     
     template<typename T, typename ...Args>
-    void Renderer::addCustomCommand(Args... args) {
-        addCommand<T>(_renderer, args...);
+    void CommandRecorder::addCustomCommand(Args&&... args) {
+        auto ptr = RenderCommand::CommandFactory::acquire<T>(_renderer, std::forward<Args>(args)...);
+        if (!ptr) return;
+        ptr->setBlendMode(_blend_mode);
+        RenderCommand::CustomCMD command{ptr, [](RenderCommand::BaseCommand* cmd) {
+            RenderCommand::CommandFactory::release<T>(static_cast<T*>(cmd));
+        }};
+        /// A custom command may set the viewport or clip on its own.
+        if (_recording) _recording->_sets_view = true;
+        else _cull_changes |= ViewUnknown;
+        if (_stats_enabled && !_recording) {
+            ++_stats_current.commands[static_cast<size_t>(RenderCommand::CommandType::Custom)];
+            ++_stats_current.custom_commands[ptr->commandType()];
+        }
+        const uint8_t FLAGS = ptr->batchable() ? RenderCommand::CommandHeader::Batchable : 0;
+        _target->push(command, FLAGS, nextSortKey(FLAGS, 0));
     }
 }
 
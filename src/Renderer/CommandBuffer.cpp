@@ -0,0 +1,156 @@
+
+#include "CommandBuffer.h"
+
+namespace MyEngine {
+    namespace RenderCommand {
+        CommandArena::CommandArena(size_t block_size) : _block_size(block_size) {}
+
+        void *CommandArena::allocate(size_t size, size_t alignment) {
+            while (_current < _blocks.size()) {
+                auto& block = _blocks[_current];
+                const auto BASE = reinterpret_cast<uintptr_t>(block.data.get());
+                const size_t OFFSET = ((BASE + _offset + alignment - 1) & ~(alignment - 1)) - BASE;
+                if (OFFSET + size <= block.size) {
+                    _used += OFFSET + size - _offset;
+                    _offset = OFFSET + size;
+                    return block.data.get() + OFFSET;
+                }
+                ++_current;
+                _offset = 0;
+            }
+            /// Out of space: grow geometrically, `reset()` merges the blocks later.
+            size_t new_size = std::max(_blocks.empty() ? _block_size : _blocks.back().size * 2,
+                                       size + alignment);
+            _blocks.push_back({std::make_unique<std::byte[]>(new_size), new_size});
+            _current = _blocks.size() - 1;
+            _offset = 0;
+            return allocate(size, alignment);
+        }
+
+        const char *CommandArena::copyString(std::string_view text) {
+            auto ptr = static_cast<char*>(allocate(text.size() + 1, 1));
+            std::memcpy(ptr, text.data(), text.size());
+            ptr[text.size()] = '\0';
+            return ptr;
+        }
+
+        const char *const *CommandArena::copyStrings(std::span<const std::string> texts) {
+            if (texts.empty()) return nullptr;
+            auto ptr = static_cast<const char**>(allocate(sizeof(const char*) * texts.size(), alignof(const char*)));
+            for (size_t i = 0; i < texts.size(); ++i) {
+                ptr[i] = copyString(texts[i]);
+            }
+            return ptr;
+        }
+
+        void CommandArena::reset() {
+            if (_blocks.size() > 1) {
+                /// Keep the whole footprint of the busiest frame in one contiguous block.
+                const size_t TOTAL = capacity();
+                _blocks.clear();
+                _blocks.push_back({std::make_unique<std::byte[]>(TOTAL), TOTAL});
+            }
+            _current = 0;
+            _offset = 0;
+            _used = 0;
+        }
+
+        size_t CommandArena::used() const {
+            return _used;
+        }
+
+        size_t CommandArena::capacity() const {
+            size_t size = 0;
+            for (auto& block : _blocks) size += block.size;
+            return size;
+        }
+
+        CommandBuffer::CommandBuffer(size_t block_size) : _arena(block_size) {
+            _records.reserve(1024);
+        }
+
+        CommandBuffer::~CommandBuffer() {
+            clear();
+        }
+
+        void CommandBuffer::clear() {
+            for (auto header : _records) {
+                release(header);
+            }
+            _records.clear();
+            _arena.reset();
+        }
+
+        void CommandBuffer::sort() {
+            radixSort(0);
+        }
+
+        void CommandBuffer::sortLayers() {
+            /// The layer is the top 16 bits of the key.
+            radixSort(48);
+        }
+
+        void CommandBuffer::adopt(CommandBuffer &other) {
+            if (&other == this) return;
+            _records.insert(_records.end(), other._records.begin(), other._records.end());
+            other._records.clear();
+        }
+
+        void CommandBuffer::radixSort(int first_shift) {
+            const size_t N = _records.size();
+            if (N < 2) return;
+            _sort_items.resize(N);
+            _sort_scratch.resize(N);
+            const uint64_t FIRST = _records[0]->sort_key;
+            uint64_t diff = 0;
+            for (size_t i = 0; i < N; ++i) {
+                _sort_items[i] = {_records[i]->sort_key, _records[i]};
+                diff |= _records[i]->sort_key ^ FIRST;
+            }
+            /// LSD radix sort, one byte per pass. Bytes that are equal in every key
+            /// can't change the order, so their passes are skipped.
+            SortItem* src = _sort_items.data();
+            SortItem* dst = _sort_scratch.data();
+            for (int shift = first_shift; shift < 64; shift += 8) {
+                if (((diff >> shift) & 0xFF) == 0) continue;
+                size_t offsets[256]{};
+                for (size_t i = 0; i < N; ++i) {
+                    ++offsets[(src[i].key >> shift) & 0xFF];
+                }
+                size_t sum = 0;
+                for (auto& offset : offsets) {
+                    const size_t COUNT = offset;
+                    offset = sum;
+                    sum += COUNT;
+                }
+                for (size_t i = 0; i < N; ++i) {
+                    dst[offsets[(src[i].key >> shift) & 0xFF]++] = src[i];
+                }
+                std::swap(src, dst);
+            }
+            for (size_t i = 0; i < N; ++i) {
+                _records[i] = src[i].record;
+            }
+        }
+
+        CommandArena &CommandBuffer::arena() {
+            return _arena;
+        }
+
+        std::vector<CommandHeader *> &CommandBuffer::records() {
+            return _records;
+        }
+
+        const std::vector<CommandHeader *> &CommandBuffer::records() const {
+            return _records;
+        }
+
+        size_t CommandBuffer::size() const {
+            return _records.size();
+        }
+
+        bool CommandBuffer::empty() const {
+            return _records.empty();
+        }
+    }
+}
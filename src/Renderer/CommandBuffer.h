@@ -0,0 +1,94 @@
+
+#ifndef MYENGINE_RENDERER_COMMANDBUFFER_H
+#define MYENGINE_RENDERER_COMMANDBUFFER_H
+#include "Commands.h"
+
+namespace MyEngine {
+    namespace RenderCommand {
+        /// Bump allocator for frame-scoped data. `reset()` rewinds it in one step and
+        /// keeps the memory, so a frame that fits in last frame's footprint never
+        /// touches the heap.
+        class CommandArena {
+        public:
+            explicit CommandArena(size_t block_size = 64 * 1024);
+            ~CommandArena() = default;
+            CommandArena(const CommandArena&) = delete;
+            CommandArena& operator=(const CommandArena&) = delete;
+
+            void* allocate(size_t size, size_t alignment);
+            template<typename T>
+            T* copy(const T* data, size_t count) {
+                static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable data can be copied!");
+                if (!data || !count) return nullptr;
+                auto ptr = static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+                std::memcpy(ptr, data, sizeof(T) * count);
+                return ptr;
+            }
+            template<typename T>
+            T* copy(std::span<const T> data) {
+                return copy(data.data(), data.size());
+            }
+            const char* copyString(std::string_view text);
+            /// Copies every string and returns an array of pointers to the copies.
+            const char* const* copyStrings(std::span<const std::string> texts);
+            void reset();
+
+            [[nodiscard]] size_t used() const;
+            [[nodiscard]] size_t capacity() const;
+        private:
+            struct Block {
+                std::unique_ptr<std::byte[]> data;
+                size_t size;
+            };
+            std::vector<Block> _blocks;
+            size_t _block_size;
+            size_t _current{0}, _offset{0}, _used{0};
+        };
+
+        /// A list of command records written into a `CommandArena`, in submission order.
+        class CommandBuffer {
+        public:
+            explicit CommandBuffer(size_t block_size = 64 * 1024);
+            ~CommandBuffer();
+            CommandBuffer(const CommandBuffer&) = delete;
+            CommandBuffer& operator=(const CommandBuffer&) = delete;
+
+            template<typename T>
+            T* push(const T& command, uint8_t flags = 0, uint64_t sort_key = 0) {
+                static_assert(std::is_trivially_destructible_v<T>, "Command records must be trivially destructible!");
+                void* ptr = _arena.allocate(sizeof(CommandRecord<T>), alignof(CommandRecord<T>));
+                auto record = new (ptr) CommandRecord<T>{CommandHeader{T::TYPE, flags, sort_key}, command};
+                _records.push_back(&record->header);
+                return &record->command;
+            }
+
+            /// Releases custom commands and rewinds the arena.
+            void clear();
+            /// Stable sort of the records by their sort key.
+            void sort();
+            /// Stable sort of the records by the layer in their sort key only.
+            void sortLayers();
+            /// Moves the records of `other` behind the own ones. Their data stays in the
+            /// arena of `other`, which must not be cleared before this buffer is.
+            void adopt(CommandBuffer& other);
+
+            [[nodiscard]] CommandArena& arena();
+            [[nodiscard]] std::vector<CommandHeader*>& records();
+            [[nodiscard]] const std::vector<CommandHeader*>& records() const;
+            [[nodiscard]] size_t size() const;
+            [[nodiscard]] bool empty() const;
+        private:
+            struct SortItem {
+                uint64_t key;
+                CommandHeader* record;
+            };
+            void radixSort(int first_shift);
+
+            CommandArena _arena;
+            std::vector<CommandHeader*> _records;
+            std::vector<SortItem> _sort_items, _sort_scratch;
+        };
+    }
+}
+
+#endif //MYENGINE_RENDERER_COMMANDBUFFER_H
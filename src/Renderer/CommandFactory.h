@@ -15,13 +15,14 @@ namespace MyEngine {
             CommandFactory& operator=(CommandFactory&&) = delete;
 
             template<typename T, typename ...Args>
-            static T* acquire(Args... args) {
-                return getPool<T>().acquire(args...);
+            static T* acquire(Args&&... args) {
+                return getPool<T>().acquire(std::forward<Args>(args)...);
             }
 
+            /// `T` must be the concrete type the command was acquired as.
             template<typename T>
-            static void release(std::unique_ptr<T> command) {
-                getPool<T>().release(std::move(command));
+            static void release(T* command) {
+                getPool<T>().release(command);
             }
 
             template<typename T>
@@ -29,10 +30,24 @@ namespace MyEngine {
                 getPool<T>();
             }
 
+            /// Prewarms the pool of `T` with `prewarm` commands and keeps at most
+            /// `max_size` released ones.
+            template<typename T>
+            static void configure(size_t prewarm, uint32_t max_size) {
+                auto& pool = getPool<T>();
+                pool.setMaxCount(max_size);
+                pool.prewarm(prewarm);
+            }
+
             template<typename T>
             static void getStatistics(size_t& current_size, size_t& max_size) {
                 getPool<T>().getStatistics(current_size, max_size);
             }
+
+            template<typename T>
+            static void getStatistics(size_t& current_size, size_t& max_size, uint64_t& hits, uint64_t& misses) {
+                getPool<T>().getStatistics(current_size, max_size, hits, misses);
+            }
         private:
             template<typename T>
             static CommandPool<T>& getPool() {
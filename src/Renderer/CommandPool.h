@@ -8,92 +8,253 @@ namespace MyEngine {
         public:
             explicit AbstractCommandPool() = default;
             virtual ~AbstractCommandPool() = default;
+
+            /// Acquisitions served by a pooled command, and those that had to allocate,
+            /// summed over every pool.
+            static uint64_t totalHits() { return _total_hits.load(std::memory_order_relaxed); }
+            static uint64_t totalMisses() { return _total_misses.load(std::memory_order_relaxed); }
+        protected:
+            void countAcquire(bool hit) {
+                if (hit) {
+                    _hits.fetch_add(1, std::memory_order_relaxed);
+                    _total_hits.fetch_add(1, std::memory_order_relaxed);
+                } else {
+                    _misses.fetch_add(1, std::memory_order_relaxed);
+                    _total_misses.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+            std::atomic<uint64_t> _hits{0}, _misses{0};
+        private:
+            static inline std::atomic<uint64_t> _total_hits{0}, _total_misses{0};
         };
 
+        class CommandFactory;
+
+        /// Released commands go to a free list owned by the releasing thread, so the
+        /// common acquire/release path never synchronizes. A thread whose list grows past
+        /// `LOCAL_LIMIT` moves it to a lock-free overflow stack shared by all threads, and
+        /// an empty list refills itself from there.
+        ///
+        /// Every type has one pool, created by `CommandFactory` and kept for the lifetime
+        /// of the process. A thread that outlives it frees its own list instead of handing
+        /// it back.
         template<typename T>
         class CommandPool : public AbstractCommandPool {
-        public:
-            explicit CommandPool(uint32_t max_commands = 1024) : _cmd_max_count(max_commands) {
-                _sub_pool_count = std::thread::hardware_concurrency();
-                if (_sub_pool_count == 0) _sub_pool_count = 4;
-                std::pmr::pool_options options = {.max_blocks_per_chunk = _sub_pool_count,
-                                                  .largest_required_pool_block = sizeof(T)};
-                _pool_res = std::make_unique<std::pmr::synchronized_pool_resource>(options);
-                for (size_t i = 0; i < _sub_pool_count; ++i) {
-                    _pools.emplace_back(std::make_unique<SubPool>());
+            friend class CommandFactory;
+            struct Node {
+                alignas(T) std::byte storage[sizeof(T)];
+                Node* next{nullptr};
+            };
+
+            struct LocalCache {
+                CommandPool* owner{nullptr};
+                /// `owner` is only touched while this is still the live pool's id.
+                uint64_t owner_id{0};
+                /// Constructed commands waiting for `reset`.
+                Node* free{nullptr};
+                Node* free_tail{nullptr};
+                size_t free_count{0};
+                /// Prewarmed storage without a command in it.
+                Node* raw{nullptr};
+
+                ~LocalCache() {
+                    detach(*this);
                 }
+            };
+
+            explicit CommandPool(uint32_t max_commands = 1024)
+                : _id(_next_id.fetch_add(1, std::memory_order_relaxed)), _cmd_max_count(max_commands) {
+                _live_id.store(_id, std::memory_order_release);
             }
-            
+        public:
+            static constexpr size_t LOCAL_LIMIT = 64;
+
+            CommandPool(const CommandPool&) = delete;
+            CommandPool& operator=(const CommandPool&) = delete;
+
             ~CommandPool() override {
-                for (std::unique_ptr<SubPool>& sub_pool : _pools) {
-                    std::lock_guard<std::mutex> lock(sub_pool->mutex);
-                    for (size_t i = 0; i < sub_pool->cmd_list.size(); ++i) {
-                        auto cmd = sub_pool->cmd_list[i].release();
-                        _pool_res->deallocate(cmd, sizeof(T), alignof(T));
-                    }
-                    sub_pool->cmd_list.clear();
+                _live_id.store(0, std::memory_order_release);
+                LocalCache& cache = local();
+                if (cache.owner == this) {
+                    flush(cache);
+                    cache.owner = nullptr;
+                    cache.owner_id = 0;
+                }
+                for (Node* node = _free_stack.exchange(nullptr, std::memory_order_acquire); node;) {
+                    Node* next = node->next;
+                    command(node)->~T();
+                    deallocate(node);
+                    node = next;
+                }
+                for (Node* node = _raw_stack.exchange(nullptr, std::memory_order_acquire); node;) {
+                    Node* next = node->next;
+                    deallocate(node);
+                    node = next;
                 }
             };
 
             template <typename ...Args>
-            T *acquire(Args ...args) {
-                uint32_t pool_idx = _cur_sub_pool_idx.fetch_add(1, std::memory_order_relaxed) % _sub_pool_count;
-                auto& sub_pool = _pools[pool_idx];
-                std::unique_lock<std::mutex> _lock(sub_pool->mutex);
-                if (sub_pool->cmd_list.empty()) {
-                    /// Use custom memery allocator to create command.
-                    void* ptr = _pool_res->allocate(sizeof(T), alignof(T));
-                    return new (ptr) T(args...);
-                }
-                T *cmd = sub_pool->cmd_list.back().release();
-                sub_pool->cmd_list.pop_back();
-                if (cmd) {
+            T *acquire(Args&& ...args) {
+                LocalCache& cache = bind();
+                if (!cache.free) refill(cache);
+                if (Node* node = cache.free) {
+                    cache.free = node->next;
+                    if (!cache.free) cache.free_tail = nullptr;
+                    --cache.free_count;
+                    _free_count.fetch_sub(1, std::memory_order_relaxed);
+                    countAcquire(true);
+                    T* cmd = command(node);
                     /// Call reset function.
-                    cmd->reset(args...);
+                    cmd->reset(std::forward<Args>(args)...);
+                    return cmd;
+                }
+                countAcquire(false);
+                if (!cache.raw) cache.raw = _raw_stack.exchange(nullptr, std::memory_order_acquire);
+                Node* node = cache.raw;
+                if (node) {
+                    cache.raw = node->next;
                 } else {
-                    /// Use custom memery allocator to create command.
-                    void* ptr = _pool_res->allocate(sizeof(T), alignof(T));
-                    cmd = new (ptr) T(args...);
-                    Logger::log("Created memory!");
+                    node = allocate();
                 }
-                return cmd;
+                return new (node->storage) T(std::forward<Args>(args)...);
             }
 
-            void release(std::unique_ptr<T> command) {
-                if (!command) return;
-                uint32_t pool_idx = _cur_sub_pool_idx.fetch_add(1, std::memory_order_relaxed) % _sub_pool_count;
-                auto& sub_pool = _pools[pool_idx];
-                std::unique_lock<std::mutex> _lock(sub_pool->mutex);
-                size_t _max_count = _cmd_max_count / _sub_pool_count;
-                if (sub_pool->cmd_list.size() + 1 >= _max_count) {
+            void release(T* cmd) {
+                if (!cmd) return;
+                Node* node = reinterpret_cast<Node*>(cmd);
+                if (_free_count.load(std::memory_order_relaxed) >= _cmd_max_count.load(std::memory_order_relaxed)) {
                     /// Remove the command.
-                    command->~T();
-                    /// Use custom deallocator to release command.
-                    _pool_res->deallocate(command.release(), sizeof(T), alignof(T));
+                    cmd->~T();
+                    deallocate(node);
                     return;
                 }
-                sub_pool->cmd_list.push_back(std::move(command));
+                _free_count.fetch_add(1, std::memory_order_relaxed);
+                LocalCache& cache = bind();
+                node->next = cache.free;
+                if (!cache.free) cache.free_tail = node;
+                cache.free = node;
+                if (++cache.free_count > LOCAL_LIMIT) {
+                    push(_free_stack, cache.free, cache.free_tail);
+                    cache.free = cache.free_tail = nullptr;
+                    cache.free_count = 0;
+                }
             }
 
-            void getStatistics(size_t& current_size, size_t& max_size) {
-                size_t size = 0;
-                for (auto& p : _pools) {
-                    size += p->cmd_list.size();
+            /// Allocates storage for `count` commands up front, so the first frames do not
+            /// hit the allocator.
+            void prewarm(size_t count) {
+                if (!count) return;
+                Node* first = allocate();
+                Node* last = first;
+                for (size_t i = 1; i < count; ++i) {
+                    Node* node = allocate();
+                    node->next = first;
+                    first = node;
                 }
-                current_size = size;
-                max_size = _cmd_max_count;
+                push(_raw_stack, first, last);
+            }
+
+            /// Released commands beyond `max_commands` are destroyed instead of kept.
+            void setMaxCount(uint32_t max_commands) {
+                _cmd_max_count.store(max_commands, std::memory_order_relaxed);
+            }
+
+            void getStatistics(size_t& current_size, size_t& max_size) {
+                current_size = _free_count.load(std::memory_order_relaxed);
+                max_size = _cmd_max_count.load(std::memory_order_relaxed);
+            }
+
+            void getStatistics(size_t& current_size, size_t& max_size, uint64_t& hits, uint64_t& misses) {
+                getStatistics(current_size, max_size);
+                hits = _hits.load(std::memory_order_relaxed);
+                misses = _misses.load(std::memory_order_relaxed);
             }
 
         private:
-            struct SubPool {
-                std::vector<std::unique_ptr<T>> cmd_list{};
-                std::mutex mutex{};
-            };
-            std::unique_ptr<std::pmr::synchronized_pool_resource> _pool_res;
-            std::mutex _mutex;
-            uint32_t _cmd_max_count, _sub_pool_count{0};
-            std::atomic<uint32_t> _cur_sub_pool_idx{0};
-            std::vector<std::unique_ptr<SubPool>> _pools;
+            static T* command(Node* node) { return std::launder(reinterpret_cast<T*>(node->storage)); }
+            static Node* allocate() { return new (::operator new(sizeof(Node), std::align_val_t{alignof(Node)})) Node; }
+            static void deallocate(Node* node) { ::operator delete(node, std::align_val_t{alignof(Node)}); }
+
+            static LocalCache& local() {
+                static thread_local LocalCache cache;
+                return cache;
+            }
+
+            LocalCache& bind() {
+                LocalCache& cache = local();
+                if (cache.owner != this || cache.owner_id != _id) {
+                    detach(cache);
+                    cache.owner = this;
+                    cache.owner_id = _id;
+                }
+                return cache;
+            }
+
+            /// Hands the lists back to their pool, or frees them if it is gone.
+            static void detach(LocalCache& cache) {
+                if (cache.owner && cache.owner_id == _live_id.load(std::memory_order_acquire)) {
+                    cache.owner->flush(cache);
+                } else {
+                    for (Node* node = cache.free; node;) {
+                        Node* next = node->next;
+                        command(node)->~T();
+                        deallocate(node);
+                        node = next;
+                    }
+                    for (Node* node = cache.raw; node;) {
+                        Node* next = node->next;
+                        deallocate(node);
+                        node = next;
+                    }
+                    cache.free = cache.free_tail = cache.raw = nullptr;
+                    cache.free_count = 0;
+                }
+                cache.owner = nullptr;
+                cache.owner_id = 0;
+            }
+
+            /// Pushing a whole chain is ABA-safe; popping takes the whole stack at once for
+            /// the same reason.
+            static void push(std::atomic<Node*>& stack, Node* first, Node* last) {
+                Node* head = stack.load(std::memory_order_relaxed);
+                do {
+                    last->next = head;
+                } while (!stack.compare_exchange_weak(head, first, std::memory_order_release,
+                                                      std::memory_order_relaxed));
+            }
+
+            void refill(LocalCache& cache) {
+                Node* node = _free_stack.exchange(nullptr, std::memory_order_acquire);
+                if (!node) return;
+                cache.free = node;
+                cache.free_count = 1;
+                while (node->next) {
+                    node = node->next;
+                    ++cache.free_count;
+                }
+                cache.free_tail = node;
+            }
+
+            /// Hands the thread's lists to the shared stacks.
+            void flush(LocalCache& cache) {
+                if (cache.free) push(_free_stack, cache.free, cache.free_tail);
+                if (cache.raw) {
+                    Node* last = cache.raw;
+                    while (last->next) last = last->next;
+                    push(_raw_stack, cache.raw, last);
+                }
+                cache.free = cache.free_tail = cache.raw = nullptr;
+                cache.free_count = 0;
+            }
+
+            static inline std::atomic<uint64_t> _next_id{1};
+            /// Id of the pool that is alive, or 0. Trivially destructible, so a thread
+            /// exiting after static destruction can still read it.
+            static inline std::atomic<uint64_t> _live_id{0};
+            const uint64_t _id;
+            std::atomic<Node*> _free_stack{nullptr}, _raw_stack{nullptr};
+            std::atomic<size_t> _free_count{0};
+            std::atomic<uint32_t> _cmd_max_count;
         };
     }
 }
@@ -0,0 +1,568 @@
+
+#include "Commands.h"
+#include "BaseCommand.h"
+#include "RenderList.h"
+#include "GlyphAtlas.h"
+#include "../Algorithm/Batch.h"
+
+namespace MyEngine {
+    /// The only callers of the batch kernels, kept out of the public headers so that
+    /// `ENABLE_AVX` only changes the code of this file.
+    namespace Graphics {
+        void Rectangle::updateAll(std::span<Rectangle* const> rects) {
+            thread_local std::vector<const Rectangle*> fills, borders;
+            thread_local Algorithm::Batch::RectangleSoA soa;
+            thread_local std::vector<SDL_FColor> colors;
+            thread_local std::vector<float> sizes;
+            thread_local std::vector<SDL_Vertex> out;
+            fills.clear();
+            borders.clear();
+            for (auto rect : rects) {
+                if (!rect) continue;
+                rect->settleOffset();
+                if ((rect->_dirty & DirtyFill) && rect->_background_color.a > 0) fills.push_back(rect);
+                if ((rect->_dirty & DirtyBorder) && rect->_border_size > 0 && rect->_border_color.a > 0) {
+                    borders.push_back(rect);
+                }
+            }
+            if (fills.size() >= BATCH_MIN) {
+                soa.clear();
+                colors.clear();
+                for (auto rect : fills) {
+                    soa.push(rect->_geometry, rect->_rotate);
+                    colors.push_back(Algorithm::convert2FColor(rect->_background_color));
+                }
+                out.resize(fills.size() * 4);
+                Algorithm::Batch::calcRectangles(soa, colors, out.data());
+                for (size_t k = 0; k < fills.size(); ++k) {
+                    std::copy_n(out.begin() + k * 4, 4, fills[k]->_vertices.begin());
+                    fills[k]->_dirty &= ~(DirtyFill | DirtyFillColor);
+                }
+            }
+            if (borders.size() >= BATCH_MIN) {
+                soa.clear();
+                colors.clear();
+                sizes.clear();
+                for (auto rect : borders) {
+                    soa.push(rect->_geometry, rect->_rotate);
+                    colors.push_back(Algorithm::convert2FColor(rect->_border_color));
+                    sizes.push_back(rect->_border_size);
+                }
+                out.resize(borders.size() * 8);
+                Algorithm::Batch::calcRectangleBorders(soa, sizes, colors, out.data());
+                for (size_t k = 0; k < borders.size(); ++k) {
+                    std::copy_n(out.begin() + k * 8, 8, borders[k]->_border_vertices.begin());
+                    borders[k]->_dirty &= ~(DirtyBorder | DirtyBorderColor);
+                }
+            }
+            for (auto rect : rects) {
+                if (rect) rect->update();
+            }
+        }
+
+        void Ellipse::tessellateAll(std::span<Ellipse* const> ellipses, std::vector<SDL_Vertex>& vertices,
+                                    std::vector<int>& indices) {
+            thread_local std::vector<Part> parts;
+            parts.clear();
+            for (auto ellipse : ellipses) {
+                if (!ellipse) continue;
+                const uint16_t SEGMENT = ellipse->segment();
+                if (ellipse->_background_color.a > 0) {
+                    parts.push_back({ellipse, vertices.size(), SEGMENT, false});
+                    appendIndices(vertices, indices, Algorithm::Topology::Fan, SEGMENT, SEGMENT + 2);
+                }
+                if (ellipse->hasBorder()) {
+                    parts.push_back({ellipse, vertices.size(), SEGMENT, true});
+                    appendIndices(vertices, indices, Algorithm::Topology::Ring, SEGMENT, (SEGMENT + 1) * 2);
+                }
+            }
+            std::stable_sort(parts.begin(), parts.end(), [](const Part& a, const Part& b) {
+                return a.ring != b.ring ? a.ring < b.ring : a.segment < b.segment;
+            });
+            for (size_t first = 0, last; first < parts.size(); first = last) {
+                last = first + 1;
+                while (last < parts.size() && parts[last].ring == parts[first].ring &&
+                       parts[last].segment == parts[first].segment) ++last;
+                if (last - first >= BATCH_MIN) {
+                    batchFill(std::span(parts).subspan(first, last - first), vertices);
+                    continue;
+                }
+                for (size_t k = first; k < last; ++k) {
+                    auto& part = parts[k];
+                    if (part.ring) part.ellipse->fillBorderVertices(vertices.data() + part.offset);
+                    else part.ellipse->fillVertices(vertices.data() + part.offset);
+                }
+            }
+        }
+
+        void Ellipse::batchFill(std::span<const Part> parts, std::vector<SDL_Vertex>& vertices) {
+            thread_local Algorithm::Batch::EllipseSoA soa;
+            thread_local std::vector<SDL_FColor> colors;
+            thread_local std::vector<float> borders;
+            thread_local std::vector<SDL_Vertex> out;
+            const bool RING = parts.front().ring;
+            const uint16_t SEGMENT = parts.front().segment;
+            soa.clear();
+            colors.clear();
+            borders.clear();
+            for (auto& part : parts) {
+                auto ellipse = part.ellipse;
+                soa.push(ellipse->_center_point, ellipse->_radius, ellipse->_degree);
+                colors.push_back(Algorithm::convert2FColor(RING ? ellipse->_border_color
+                                                                : ellipse->_background_color));
+                borders.push_back(ellipse->_border_size);
+            }
+            const Algorithm::UnitCircle& circle = Algorithm::unitCircle(SEGMENT);
+            const size_t PER_SHAPE = RING ? (SEGMENT + 1) * 2 : SEGMENT + 2;
+            out.resize(soa.size() * PER_SHAPE);
+            if (RING) {
+                Algorithm::Batch::calcEllipseRings(soa, circle, borders, colors, out.data());
+            } else {
+                Algorithm::Batch::calcEllipses(soa, circle, colors, out.data());
+            }
+            for (size_t k = 0; k < parts.size(); ++k) {
+                std::copy_n(out.begin() + k * PER_SHAPE, PER_SHAPE, vertices.begin() + parts[k].offset);
+            }
+        }
+    }
+
+    namespace RenderCommand {
+        const char *commandTypeName(CommandType type) {
+            switch (type) {
+                case CommandType::BlendMode: return "BlendMode";
+                case CommandType::Fill: return "Fill";
+                case CommandType::Viewport: return "Viewport";
+                case CommandType::ClipView: return "ClipView";
+                case CommandType::Texture: return "Texture";
+                case CommandType::Point: return "Point";
+                case CommandType::Line: return "Line";
+                case CommandType::Rectangle: return "Rectangle";
+                case CommandType::Triangle: return "Triangle";
+                case CommandType::Ellipse: return "Ellipse";
+                case CommandType::Text: return "Text";
+                case CommandType::DebugText: return "Debug";
+                case CommandType::GlyphText: return "GlyphText";
+                case CommandType::Number: return "Number";
+                case CommandType::Geometry: return "Geometry";
+                case CommandType::Instances: return "Instances";
+                case CommandType::CachedText: return "CachedText";
+                case CommandType::List: return "List";
+                case CommandType::Layer: return "Layer";
+                case CommandType::Custom: return "Custom";
+                default: return "Unknown";
+            }
+        }
+
+        uint64_t packSortKey(int16_t layer, uint32_t segment, uint32_t state) {
+            const uint64_t LAYER_BITS = static_cast<uint16_t>(static_cast<int32_t>(layer) + 32768);
+            return (LAYER_BITS << 48) | (static_cast<uint64_t>(segment & 0xFFFFFF) << 24) | (state & 0xFFFFFF);
+        }
+
+        uint32_t packStateKey(SDL_BlendMode blend_mode, const void *texture, CommandType type) {
+            const auto BLEND = static_cast<uint32_t>(blend_mode);
+            const uint32_t BLEND_BITS = (BLEND ^ (BLEND >> 4) ^ (BLEND >> 8) ^ (BLEND >> 16) ^ (BLEND >> 24)) & 0xF;
+            /// Equal textures only need equal bits; a collision just costs a batch.
+            const uint64_t HASH = (reinterpret_cast<uintptr_t>(texture) >> 4) * 0x9E3779B97F4A7C15ull;
+            const auto TEXTURE_BITS = static_cast<uint32_t>(HASH >> 48);
+            return (BLEND_BITS << 20) | (TEXTURE_BITS << 4) | (static_cast<uint32_t>(type) & 0xF);
+        }
+
+        void BlendModeCMD::exec(const RenderContext &context) const {
+            auto _ret = context.setDrawBlendMode(blend_mode);
+            if (!_ret) {
+                Logger::log(std::format("Renderer: Set render draw blend mode failed! Exception: {}",
+                                        SDL_GetError()), Logger::Warn);
+            }
+        }
+
+        void FillCMD::exec(const RenderContext &context) const {
+            context.setDrawColor(color);
+            auto _ret = SDL_RenderClear(context.renderer);
+            context.countDraw();
+            if (!_ret) {
+                Logger::log(std::format("Renderer: Render clear failed! Exception: {}",
+                                        SDL_GetError()), Logger::Error);
+            }
+        }
+
+        void ViewPortCMD::exec(const RenderContext &context) const {
+            bool _ret = context.setViewport(reset ? nullptr : &rect);
+            if (!_ret) {
+                Logger::log(std::format("Renderer: Set renderer viewport failed! Exception: {}",
+                                        SDL_GetError()), Logger::Warn);
+            }
+        }
+
+        void ClipViewCMD::exec(const RenderContext &context) const {
+            bool _ret = context.setClipRect(reset ? nullptr : &rect);
+            if (!_ret) {
+                Logger::log(std::format("Renderer: Set renderer clip rect failed! Exception: {}",
+                                        SDL_GetError()), Logger::Warn);
+            }
+        }
+
+        const void *TextureCMD::batchTexture() const {
+            if (mode == Mode::Custom) return count ? textures[0] : nullptr;
+            return texture;
+        }
+
+        void TextureCMD::exec(const RenderContext &context) const {
+            if (mode == Mode::Single) {
+                render(context, texture, property);
+            } else if (mode == Mode::Multiple) {
+                for (uint32_t i = 0; i < count; ++i) {
+                    render(context, texture, properties[i]);
+                }
+            } else if (mode == Mode::Custom) {
+                for (uint32_t i = 0; i < count; ++i) {
+                    render(context, textures[i], properties[i]);
+                }
+            }
+        }
+
+        void TextureCMD::render(const RenderContext &context, SDL_Texture *texture, const TextureProperty *prop) {
+            static constexpr int QUAD_INDICES[6] = { 0, 1, 2, 0, 2, 3 };
+            if (!texture || !prop) return;
+            auto scaled = prop->scaledGeometry();
+            if (scaled.size.width == 0 || scaled.size.height == 0 || texture->w <= 0 || texture->h <= 0) return;
+            SDL_FRect tex_coord = {0.f, 0.f, 1.f, 1.f};
+            if (prop->clip_mode) {
+                const float W = static_cast<float>(texture->w), H = static_cast<float>(texture->h);
+                tex_coord = {prop->clip_area.x / W, prop->clip_area.y / H,
+                             prop->clip_area.w / W, prop->clip_area.h / H};
+            }
+            std::array<SDL_Vertex, 4> vertices{};
+            Algorithm::calcSprite(scaled, prop->scaledAnchor(), prop->rotate_angle, prop->flip_mode,
+                                  tex_coord, prop->color_alpha, vertices);
+            context.renderGeometry(vertices.data(), 4, QUAD_INDICES, 6, texture);
+        }
+
+        void PointCMD::exec(const RenderContext &context) const {
+            if (mode == Mode::Single) {
+                render(context, point);
+            } else if (mode == Mode::Multiple) {
+                for (uint32_t i = 0; i < count; ++i) {
+                    render(context, points[i]);
+                }
+            }
+        }
+
+        void PointCMD::render(const RenderContext &context, Graphics::Point *point) {
+            if (point->size() == 1) {
+                const auto pos = point->position();
+                auto _ret = context.renderPoint(pos.x, pos.y, point->color());
+                if (!_ret) {
+                    Logger::log(std::format("Renderer: Set render point failed! Exception: {}",
+                                            SDL_GetError()), Logger::Error);
+                }
+            } else {
+                context.renderGeometry(point->vertices(), point->verticesCount(),
+                                       point->indices(), point->indicesCount());
+            }
+        }
+
+        void LineCMD::exec(const RenderContext &context) const {
+            if (mode == Mode::Single) {
+                render(context, line);
+            } else if (mode == Mode::Multiple) {
+                for (uint32_t i = 0; i < count; ++i) {
+                    render(context, lines[i]);
+                }
+            }
+        }
+
+        void LineCMD::render(const RenderContext &context, Graphics::Line *line) {
+            const auto SIZE = line->size();
+            const auto START = line->startPosition();
+            const auto END = line->endPosition();
+            if (!SIZE) return;
+            if (SIZE == 1) {
+                auto _ret = context.renderLine(START.x, START.y, END.x, END.y, line->color());
+                if (!_ret) {
+                    Logger::log(std::format("Renderer: Set render line failed! Exception: {}",
+                                            SDL_GetError()), Logger::Error);
+                }
+            } else {
+                context.renderGeometry(line->vertices(), line->vertexCount(), line->indices(), line->indicesCount());
+            }
+        }
+
+        void RectangleCMD::exec(const RenderContext &context) const {
+            if (mode == Mode::Single) {
+                render(context, rect);
+            } else if (mode == Mode::Multiple) {
+                Graphics::Rectangle::updateAll({rects, count});
+                for (uint32_t i = 0; i < count; ++i) {
+                    render(context, rects[i]);
+                }
+            }
+        }
+
+        void RectangleCMD::render(const RenderContext &context, Graphics::Rectangle *rect) {
+            bool border = (rect->borderSize() > 0) && (rect->borderColor().a > 0);
+            if (rect->backgroundColor().a > 0) {
+                context.renderGeometry(rect->vertices(), rect->verticesCount(),
+                                       rect->indices(), rect->indicesCount());
+            }
+            if (!border) return;
+            context.renderGeometry(rect->borderVertices(), rect->borderVerticesCount(),
+                                   rect->borderIndices(), rect->borderIndicesCount());
+        }
+
+        void TriangleCMD::exec(const RenderContext &context) const {
+            if (mode == Mode::Single) {
+                render(context, triangle);
+            } else if (mode == Mode::Multiple) {
+                for (uint32_t i = 0; i < count; ++i) {
+                    render(context, triangles[i]);
+                }
+            }
+        }
+
+        void TriangleCMD::render(const RenderContext &context, Graphics::Triangle *triangle) {
+            bool filled = (triangle->backgroundColor().a > 0);
+            bool bordered = (triangle->borderSize() > 0 && triangle->borderColor().a > 0);
+            if (filled) {
+                context.renderGeometry(triangle->vertices(), 3, triangle->indices(), 3);
+            }
+            if (bordered) {
+                const auto SIZE = triangle->borderSize();
+                if (SIZE == 1) {
+                    const auto COLOR = triangle->borderColor();
+                    const auto P1 = triangle->position(0), P2 = triangle->position(1), P3 = triangle->position(2);
+                    int err_cnt = 0;
+                    err_cnt += context.renderLine(P1.x, P1.y, P2.x, P2.y, COLOR);
+                    err_cnt += context.renderLine(P3.x, P3.y, P2.x, P2.y, COLOR);
+                    err_cnt += context.renderLine(P1.x, P1.y, P3.x, P3.y, COLOR);
+                    if (err_cnt < 3) {
+                        Logger::log(std::format("Renderer: Set render triangle failed! Exception: {}",
+                                                SDL_GetError()), Logger::Error);
+                    }
+                } else {
+                    context.renderGeometry(triangle->borderVertices(), triangle->borderVerticesCount(),
+                                           triangle->borderIndices(), triangle->borderIndicesCount());
+                }
+            }
+        }
+
+        void EllipseCMD::exec(const RenderContext &context) const {
+            if (mode == Mode::Single) {
+                render(context, ellipse);
+            } else if (mode == Mode::Multiple) {
+                thread_local std::vector<SDL_Vertex> vertices;
+                thread_local std::vector<int> indices;
+                vertices.clear();
+                indices.clear();
+                Graphics::Ellipse::tessellateAll({ellipses, count}, vertices, indices);
+                context.renderGeometry(vertices.data(), static_cast<int>(vertices.size()),
+                                       indices.data(), static_cast<int>(indices.size()));
+            }
+        }
+
+        void EllipseCMD::render(const RenderContext &context, Graphics::Ellipse *ellipse) {
+            bool filled = (ellipse->backgroundColor().a > 0);
+            bool bordered = ellipse->hasBorder();
+            if (filled) {
+                context.renderGeometry(ellipse->vertices(), ellipse->vertexCount(),
+                                       ellipse->indices(), ellipse->indicesCount());
+            }
+            if (bordered) {
+                context.renderGeometry(ellipse->borderVertices(), ellipse->borderVerticesCount(),
+                                       ellipse->borderIndices(), ellipse->borderIndicesCount());
+            }
+        }
+
+        void TextCMD::exec(const RenderContext &context) const {
+            if (mode == Mode::Single) {
+                render(context, text, position);
+            } else if (mode == Mode::Multiple) {
+                for (uint32_t i = 0; i < count; ++i) {
+                    render(context, text, *positions[i]);
+                }
+            } else if (mode == Mode::Custom) {
+                for (uint32_t i = 0; i < count; ++i) {
+                    render(context, texts[i], *positions[i]);
+                }
+            }
+        }
+
+        void TextCMD::render(const RenderContext &context, TTF_Text *text, const Vector2& position) {
+            bool _ret = TTF_DrawRendererText(text, position.x, position.y);
+            context.countDraw();
+            if (!_ret) {
+                Logger::log(std::format("Renderer: Set render text failed! Exception: {}",
+                                        SDL_GetError()), Logger::Error);
+            }
+        }
+
+        void DebugTextCMD::exec(const RenderContext &context) const {
+            auto _ret = context.setDrawColor(color);
+            if (!_ret) {
+                Logger::log(std::format("Renderer: Set render draw color failed! Exception: {}",
+                                        SDL_GetError()), Logger::Warn);
+            }
+            if (mode == Mode::Single) {
+                render(context, text, position);
+            } else if (mode == Mode::Multiple) {
+                for (uint32_t i = 0; i < count; ++i) {
+                    render(context, texts[i], *positions[i]);
+                }
+            }
+        }
+
+        void DebugTextCMD::render(const RenderContext &context, const char *text, const Vector2& position) {
+            auto _ret = SDL_RenderDebugText(context.renderer, position.x, position.y, text);
+            context.countDraw();
+            if (!_ret) {
+                Logger::log(std::format("Renderer: Set render debug text failed! Exception: {}",
+                                        SDL_GetError()), Logger::Warn);
+            }
+        }
+
+        void GlyphTextCMD::exec(const RenderContext &context) const {
+            if (atlas) atlas->draw(context, font, {text, length}, position, color, size);
+        }
+
+        void NumberCMD::exec(const RenderContext &context) const {
+            if (!atlas) return;
+            /// The digit table has no letters, so these take the regular glyph lookup.
+            if (decimals >= 0 && !std::isfinite(real)) {
+                const std::string_view TEXT = std::isnan(real) ? "nan" : real < 0 ? "-inf" : "inf";
+                atlas->draw(context, font, TEXT, position, color, size);
+                return;
+            }
+            /// Wide enough for any int64_t, and for any double with up to 15 decimals.
+            char buffer[336];
+            const auto RESULT = decimals < 0
+                    ? std::to_chars(buffer, buffer + sizeof(buffer), integer)
+                    : std::to_chars(buffer, buffer + sizeof(buffer), real, std::chars_format::fixed, decimals);
+            if (RESULT.ec != std::errc()) return;
+            atlas->drawNumber(context, font, {buffer, RESULT.ptr}, position, color, size);
+        }
+
+        void GeometryCMD::exec(const RenderContext &context) const {
+            context.renderGeometry(vertices, static_cast<int>(vertex_count), indices,
+                                   static_cast<int>(index_count), texture);
+        }
+
+        void CachedTextCMD::exec(const RenderContext &context) const {
+            if (cache) cache->draw(context, entry, position);
+        }
+
+        void InstancesCMD::exec(const RenderContext &context) const {
+            /// Shapes are expanded in chunks, so the scratch memory stays small however many
+            /// instances there are.
+            static constexpr size_t CHUNK_VERTICES = 16384;
+            thread_local std::vector<SDL_Vertex> vertices;
+            thread_local std::vector<int> indices;
+            auto flush = [&context] {
+                if (indices.empty()) return;
+                context.renderGeometry(vertices.data(), static_cast<int>(vertices.size()),
+                                       indices.data(), static_cast<int>(indices.size()));
+                vertices.clear();
+                indices.clear();
+            };
+            vertices.clear();
+            indices.clear();
+            for (uint32_t i = 0; i < count; ++i) {
+                const SDL_FColor COLOR = Algorithm::convert2FColor(colors[color_count > 1 ? i : 0]);
+                const float VALUE = values ? values[value_count > 1 ? i : 0] : 0.f;
+                const int BASE = static_cast<int>(vertices.size());
+                const Vector2& pos = positions[i];
+                if (shape == Shape::Circle) {
+                    if (VALUE <= 0) continue;
+                    const uint16_t SEGMENT = segment ? segment : Algorithm::adaptiveSegment(VALUE);
+                    const Algorithm::UnitCircle& circle = Algorithm::unitCircle(SEGMENT);
+                    vertices.push_back({{pos.x, pos.y}, COLOR, {0, 0}});
+                    for (uint16_t j = 0; j < SEGMENT; ++j) {
+                        vertices.push_back({{pos.x + circle.cos[j] * VALUE, pos.y + circle.sin[j] * VALUE},
+                                            COLOR, {0, 0}});
+                        indices.insert(indices.end(), {BASE, BASE + 1 + j, BASE + 1 + (j + 1) % SEGMENT});
+                    }
+                } else if (shape == Shape::Rectangle) {
+                    const float HW = sizes[i].width * 0.5f, HH = sizes[i].height * 0.5f;
+                    const float CX = pos.x + HW, CY = pos.y + HH;
+                    float c = 1.f, s = 0.f;
+                    const float DEGREE = rotations ? rotations[rotation_count > 1 ? i : 0] : 0.f;
+                    if (DEGREE != 0) {
+                        const float RAD = DEGREE * static_cast<float>(M_PI) / 180.f;
+                        c = cosf(RAD);
+                        s = sinf(RAD);
+                    }
+                    static constexpr float SIGNS[4][2] = {{-1, -1}, {1, -1}, {1, 1}, {-1, 1}};
+                    for (auto& sign : SIGNS) {
+                        const float X = sign[0] * HW, Y = sign[1] * HH;
+                        vertices.push_back({{CX + X * c - Y * s, CY + X * s + Y * c}, COLOR, {0, 0}});
+                    }
+                    indices.insert(indices.end(), {BASE, BASE + 1, BASE + 2, BASE, BASE + 2, BASE + 3});
+                } else {
+                    /// The same quad as `Algorithm::calcLine`, extended by half the thickness at both ends.
+                    const float DX = ends[i].x - pos.x, DY = ends[i].y - pos.y;
+                    const float LEN = hypotf(DX, DY);
+                    if (VALUE <= 0 || LEN == 0) continue;
+                    const float UX = DX / LEN * VALUE * 0.5f, UY = DY / LEN * VALUE * 0.5f;
+                    vertices.push_back({{pos.x - UX + UY, pos.y - UY - UX}, COLOR, {0, 0}});
+                    vertices.push_back({{pos.x - UX - UY, pos.y - UY + UX}, COLOR, {0, 0}});
+                    vertices.push_back({{ends[i].x + UX - UY, ends[i].y + UY + UX}, COLOR, {0, 0}});
+                    vertices.push_back({{ends[i].x + UX + UY, ends[i].y + UY - UX}, COLOR, {0, 0}});
+                    indices.insert(indices.end(), {BASE, BASE + 1, BASE + 2, BASE, BASE + 2, BASE + 3});
+                }
+                if (vertices.size() >= CHUNK_VERTICES) flush();
+            }
+            flush();
+        }
+
+        void RenderListCMD::exec(const RenderContext &context) const {
+            if (list) list->replay(context);
+        }
+
+        void LayerCMD::exec(const RenderContext &context) const {
+            layer->composite(context);
+        }
+
+        void CustomCMD::exec(const RenderContext &context) const {
+            command->setContext(&context);
+            command->exec();
+            command->setContext(nullptr);
+            /// The command may have changed any state behind the cache's back.
+            if (context.state) context.state->invalidate();
+        }
+
+        template<typename T>
+        static inline const T& payload(const CommandHeader *header) {
+            return reinterpret_cast<const CommandRecord<T>*>(header)->command;
+        }
+
+        void execute(const CommandHeader *header, const RenderContext &context) {
+            switch (header->type) {
+                case CommandType::BlendMode: payload<BlendModeCMD>(header).exec(context); break;
+                case CommandType::Fill: payload<FillCMD>(header).exec(context); break;
+                case CommandType::Viewport: payload<ViewPortCMD>(header).exec(context); break;
+                case CommandType::ClipView: payload<ClipViewCMD>(header).exec(context); break;
+                case CommandType::Texture: payload<TextureCMD>(header).exec(context); break;
+                case CommandType::Point: payload<PointCMD>(header).exec(context); break;
+                case CommandType::Line: payload<LineCMD>(header).exec(context); break;
+                case CommandType::Rectangle: payload<RectangleCMD>(header).exec(context); break;
+                case CommandType::Triangle: payload<TriangleCMD>(header).exec(context); break;
+                case CommandType::Ellipse: payload<EllipseCMD>(header).exec(context); break;
+                case CommandType::Text: payload<TextCMD>(header).exec(context); break;
+                case CommandType::DebugText: payload<DebugTextCMD>(header).exec(context); break;
+                case CommandType::GlyphText: payload<GlyphTextCMD>(header).exec(context); break;
+                case CommandType::Number: payload<NumberCMD>(header).exec(context); break;
+                case CommandType::Geometry: payload<GeometryCMD>(header).exec(context); break;
+                case CommandType::Instances: payload<InstancesCMD>(header).exec(context); break;
+                case CommandType::CachedText: payload<CachedTextCMD>(header).exec(context); break;
+                case CommandType::List: payload<RenderListCMD>(header).exec(context); break;
+                case CommandType::Layer: payload<LayerCMD>(header).exec(context); break;
+                case CommandType::Custom: payload<CustomCMD>(header).exec(context); break;
+                default: break;
+            }
+        }
+
+        void release(CommandHeader *header) {
+            if (header->type != CommandType::Custom) return;
+            auto& cmd = payload<CustomCMD>(header);
+            if (cmd.command && cmd.release) cmd.release(cmd.command);
+        }
+    }
+}
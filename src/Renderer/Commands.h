@@ -0,0 +1,366 @@
+
+#ifndef MYENGINE_RENDERER_COMMANDS_H
+#define MYENGINE_RENDERER_COMMANDS_H
+#include "../Basic.h"
+#include "RenderContext.h"
+#include "TextCache.h"
+
+namespace MyEngine {
+    class TextureProperty;
+    class RenderLayer;
+
+    namespace RenderCommand {
+        class BaseCommand;
+        class RenderList;
+        class GlyphAtlas;
+
+        enum class Mode {
+            Single,
+            Multiple,
+            Custom
+        };
+
+        /// Batchable types have to stay below 16, as the state key keeps 4 bits of them.
+        enum class CommandType : uint8_t {
+            BlendMode,
+            Fill,
+            Viewport,
+            ClipView,
+            Texture,
+            Point,
+            Line,
+            Rectangle,
+            Triangle,
+            Ellipse,
+            GlyphText,
+            Number,
+            Geometry,
+            Instances,
+            CachedText,
+            Text,
+            DebugText,
+            List,
+            Layer,
+            Custom,
+            Count
+        };
+
+        [[nodiscard]] const char* commandTypeName(CommandType type);
+
+        /// Precedes every record in a command buffer.
+        struct CommandHeader {
+            enum Flag : uint8_t {
+                Batchable = 0x1,
+                Sortable = 0x2
+            };
+            CommandType type;
+            uint8_t flags;
+            uint64_t sort_key;
+        };
+
+        template<typename T>
+        struct CommandRecord {
+            CommandHeader header;
+            T command;
+        };
+
+        /// | layer (16) | segment (24) | state (24) |
+        /// The segment grows at every command that must not be reordered, so sorting only
+        /// moves draws within their layer and between two such commands.
+        [[nodiscard]] uint64_t packSortKey(int16_t layer, uint32_t segment, uint32_t state);
+        /// | blend mode (4) | texture (16) | primitive (4) |
+        [[nodiscard]] uint32_t packStateKey(SDL_BlendMode blend_mode, const void* texture, CommandType type);
+
+        /// The built-in commands below are trivially copyable records. Arrays they point
+        /// to live in the same command buffer, everything else is owned by the caller
+        /// and has to stay alive until the frame is rendered.
+        struct BlendModeCMD {
+            static constexpr CommandType TYPE = CommandType::BlendMode;
+            static constexpr bool BATCHABLE = false;
+            SDL_BlendMode blend_mode;
+
+            void exec(const RenderContext& context) const;
+        };
+
+        struct FillCMD {
+            static constexpr CommandType TYPE = CommandType::Fill;
+            static constexpr bool BATCHABLE = false;
+            SDL_Color color;
+
+            void exec(const RenderContext& context) const;
+        };
+
+        struct ViewPortCMD {
+            static constexpr CommandType TYPE = CommandType::Viewport;
+            static constexpr bool BATCHABLE = false;
+            SDL_Rect rect;
+            bool reset;
+
+            void exec(const RenderContext& context) const;
+        };
+
+        struct ClipViewCMD {
+            static constexpr CommandType TYPE = CommandType::ClipView;
+            static constexpr bool BATCHABLE = false;
+            SDL_Rect rect;
+            bool reset;
+
+            void exec(const RenderContext& context) const;
+        };
+
+        struct TextureCMD {
+            static constexpr CommandType TYPE = CommandType::Texture;
+            static constexpr bool BATCHABLE = true;
+            SDL_Texture* texture;
+            TextureProperty* property;
+            Mode mode;
+            uint32_t count;
+            TextureProperty* const* properties;
+            SDL_Texture* const* textures;
+
+            [[nodiscard]] const void* batchTexture() const;
+            void exec(const RenderContext& context) const;
+            static void render(const RenderContext& context, SDL_Texture* texture, const TextureProperty* prop);
+        };
+
+        struct PointCMD {
+            static constexpr CommandType TYPE = CommandType::Point;
+            static constexpr bool BATCHABLE = true;
+            Graphics::Point* point;
+            Mode mode;
+            uint32_t count;
+            Graphics::Point* const* points;
+
+            [[nodiscard]] const void* batchTexture() const { return nullptr; }
+            void exec(const RenderContext& context) const;
+            static void render(const RenderContext& context, Graphics::Point* point);
+        };
+
+        struct LineCMD {
+            static constexpr CommandType TYPE = CommandType::Line;
+            static constexpr bool BATCHABLE = true;
+            Graphics::Line* line;
+            Mode mode;
+            uint32_t count;
+            Graphics::Line* const* lines;
+
+            [[nodiscard]] const void* batchTexture() const { return nullptr; }
+            void exec(const RenderContext& context) const;
+            static void render(const RenderContext& context, Graphics::Line* line);
+        };
+
+        struct RectangleCMD {
+            static constexpr CommandType TYPE = CommandType::Rectangle;
+            static constexpr bool BATCHABLE = true;
+            Graphics::Rectangle* rect;
+            Mode mode;
+            uint32_t count;
+            Graphics::Rectangle* const* rects;
+
+            [[nodiscard]] const void* batchTexture() const { return nullptr; }
+            void exec(const RenderContext& context) const;
+            static void render(const RenderContext& context, Graphics::Rectangle* rect);
+        };
+
+        struct TriangleCMD {
+            static constexpr CommandType TYPE = CommandType::Triangle;
+            static constexpr bool BATCHABLE = true;
+            Graphics::Triangle* triangle;
+            Mode mode;
+            uint32_t count;
+            Graphics::Triangle* const* triangles;
+
+            [[nodiscard]] const void* batchTexture() const { return nullptr; }
+            void exec(const RenderContext& context) const;
+            static void render(const RenderContext& context, Graphics::Triangle* triangle);
+        };
+
+        struct EllipseCMD {
+            static constexpr CommandType TYPE = CommandType::Ellipse;
+            static constexpr bool BATCHABLE = true;
+            Graphics::Ellipse* ellipse;
+            Mode mode;
+            uint32_t count;
+            Graphics::Ellipse* const* ellipses;
+
+            [[nodiscard]] const void* batchTexture() const { return nullptr; }
+            void exec(const RenderContext& context) const;
+            static void render(const RenderContext& context, Graphics::Ellipse* ellipse);
+        };
+
+        struct TextCMD {
+            static constexpr CommandType TYPE = CommandType::Text;
+            static constexpr bool BATCHABLE = false;
+            TTF_Text* text;
+            Vector2 position;
+            Mode mode;
+            uint32_t count;
+            Vector2* const* positions;
+            TTF_Text* const* texts;
+
+            void exec(const RenderContext& context) const;
+            static void render(const RenderContext& context, TTF_Text* text, const Vector2& position);
+        };
+
+        struct DebugTextCMD {
+            static constexpr CommandType TYPE = CommandType::DebugText;
+            static constexpr bool BATCHABLE = false;
+            const char* text;
+            Vector2 position;
+            SDL_Color color;
+            Mode mode;
+            uint32_t count;
+            const char* const* texts;
+            Vector2* const* positions;
+
+            void exec(const RenderContext& context) const;
+            static void render(const RenderContext& context, const char* text, const Vector2& position);
+        };
+
+        /// Text drawn from the glyphs of a `GlyphAtlas`. The string lives in the command
+        /// buffer; the font has to stay open until the frame is rendered.
+        struct GlyphTextCMD {
+            static constexpr CommandType TYPE = CommandType::GlyphText;
+            static constexpr bool BATCHABLE = true;
+            GlyphAtlas* atlas;
+            TTF_Font* font;
+            const char* text;
+            uint32_t length;
+            Vector2 position;
+            SDL_Color color;
+            /// Point size to scale the glyphs to, or 0 for the font's own size.
+            float size;
+
+            [[nodiscard]] const void* batchTexture() const { return atlas; }
+            void exec(const RenderContext& context) const;
+        };
+
+        /// A number drawn from the digit glyphs of a `GlyphAtlas`. It is formatted into a
+        /// stack buffer when executed, so nothing is allocated for it.
+        struct NumberCMD {
+            static constexpr CommandType TYPE = CommandType::Number;
+            static constexpr bool BATCHABLE = true;
+            GlyphAtlas* atlas;
+            TTF_Font* font;
+            /// `integer` is drawn if `decimals` is negative, `real` otherwise.
+            int64_t integer;
+            double real;
+            int8_t decimals;
+            Vector2 position;
+            SDL_Color color;
+            float size;
+
+            [[nodiscard]] const void* batchTexture() const { return atlas; }
+            void exec(const RenderContext& context) const;
+        };
+
+        /// Vertex data captured from another batchable command at submission, so it no
+        /// longer depends on the objects it was drawn from.
+        struct GeometryCMD {
+            static constexpr CommandType TYPE = CommandType::Geometry;
+            static constexpr bool BATCHABLE = true;
+            SDL_Texture* texture;
+            const SDL_Vertex* vertices;
+            const int* indices;
+            uint32_t vertex_count;
+            uint32_t index_count;
+
+            [[nodiscard]] const void* batchTexture() const { return texture; }
+            void exec(const RenderContext& context) const;
+        };
+
+        /// Many plain circles, rectangles or lines given as arrays, one entry per shape.
+        /// Arrays whose count is 1 apply to every shape.
+        struct InstancesCMD {
+            static constexpr CommandType TYPE = CommandType::Instances;
+            static constexpr bool BATCHABLE = true;
+            enum class Shape : uint8_t {
+                Circle,
+                Rectangle,
+                Line
+            };
+            Shape shape;
+            /// Segments per circle; 0 picks them from each radius.
+            uint16_t segment;
+            uint32_t count;
+            /// Circle centers, rectangle top-left corners or line starts.
+            const Vector2* positions;
+            /// Line ends.
+            const Vector2* ends;
+            /// Rectangle sizes.
+            const Size* sizes;
+            /// Circle radii or line thicknesses.
+            const float* values;
+            uint32_t value_count;
+            /// Rectangle rotations in degrees around their centers.
+            const float* rotations;
+            uint32_t rotation_count;
+            const SDL_Color* colors;
+            uint32_t color_count;
+
+            [[nodiscard]] const void* batchTexture() const { return nullptr; }
+            void exec(const RenderContext& context) const;
+        };
+
+        /// A string drawn from a texture of a `TextCache`, which renders it here the first
+        /// time. The entry stays alive until the frame it was drawn in is rendered.
+        struct CachedTextCMD {
+            static constexpr CommandType TYPE = CommandType::CachedText;
+            static constexpr bool BATCHABLE = true;
+            TextCache* cache;
+            TextCache::Entry* entry;
+            Vector2 position;
+
+            [[nodiscard]] const void* batchTexture() const { return entry; }
+            void exec(const RenderContext& context) const;
+        };
+
+        /// Replays a recorded `RenderList`, which has to outlive the frame.
+        struct RenderListCMD {
+            static constexpr CommandType TYPE = CommandType::List;
+            static constexpr bool BATCHABLE = false;
+            const RenderList* list;
+
+            void exec(const RenderContext& context) const;
+        };
+
+        /// Draws a `RenderLayer`, rendering its content into its texture first if needed.
+        struct LayerCMD {
+            static constexpr CommandType TYPE = CommandType::Layer;
+            static constexpr bool BATCHABLE = false;
+            RenderLayer* layer;
+
+            void exec(const RenderContext& context) const;
+        };
+
+        /// Wraps a pooled `BaseCommand` subclass; `release` hands it back to its own pool.
+        struct CustomCMD {
+            static constexpr CommandType TYPE = CommandType::Custom;
+            static constexpr bool BATCHABLE = false;
+            BaseCommand* command;
+            void (*release)(BaseCommand* command);
+
+            void exec(const RenderContext& context) const;
+        };
+
+        /// Commands whose data all lives in the command buffer. Snapshots keep them as
+        /// they are instead of turning them into vertex data at submission.
+        template<typename T>
+        inline constexpr bool SELF_CONTAINED = false;
+        template<>
+        inline constexpr bool SELF_CONTAINED<GlyphTextCMD> = true;
+        template<>
+        inline constexpr bool SELF_CONTAINED<NumberCMD> = true;
+        template<>
+        inline constexpr bool SELF_CONTAINED<InstancesCMD> = true;
+        template<>
+        inline constexpr bool SELF_CONTAINED<GeometryCMD> = true;
+        template<>
+        inline constexpr bool SELF_CONTAINED<CachedTextCMD> = true;
+
+        void execute(const CommandHeader* header, const RenderContext& context);
+        void release(CommandHeader* header);
+    }
+}
+
+#endif //MYENGINE_RENDERER_COMMANDS_H
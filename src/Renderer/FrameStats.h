@@ -0,0 +1,45 @@
+
+#ifndef MYENGINE_RENDERER_FRAMESTATS_H
+#define MYENGINE_RENDERER_FRAMESTATS_H
+#include "Commands.h"
+
+namespace MyEngine {
+    namespace RenderCommand {
+        /// What one frame of a renderer cost, see `Renderer::setFrameStatsEnabled`.
+        struct FrameStats {
+            uint64_t frame{0};
+            /// Commands submitted for the frame, by type.
+            std::array<uint32_t, static_cast<size_t>(CommandType::Count)> commands{};
+            /// Custom commands by `BaseCommand::commandType()`.
+            std::unordered_map<std::string, uint32_t> custom_commands;
+            uint64_t draw_calls{0};
+            uint64_t vertices{0};
+            uint64_t indices{0};
+            /// State changes sent to SDL, and those the state cache skipped.
+            uint64_t state_changes{0};
+            uint64_t state_skipped{0};
+            uint64_t culled{0};
+            /// Custom command pool acquisitions; pools are shared by all renderers.
+            uint64_t pool_hits{0};
+            uint64_t pool_misses{0};
+            /// Executing the commands and presenting, in milliseconds.
+            double execute_time{0};
+            double present_time{0};
+
+            [[nodiscard]] uint32_t commandCount(CommandType type) const {
+                return commands[static_cast<size_t>(type)];
+            }
+            [[nodiscard]] uint64_t totalCommands() const {
+                uint64_t total = 0;
+                for (auto count : commands) total += count;
+                return total;
+            }
+            [[nodiscard]] double poolHitRatio() const {
+                const uint64_t TOTAL = pool_hits + pool_misses;
+                return TOTAL ? static_cast<double>(pool_hits) / static_cast<double>(TOTAL) : 0.0;
+            }
+        };
+    }
+}
+
+#endif //MYENGINE_RENDERER_FRAMESTATS_H
@@ -0,0 +1,125 @@
+
+#include "GeometryBatch.h"
+#include "../Utils/Logger.h"
+
+namespace MyEngine {
+    namespace RenderCommand {
+        GeometryBatch::GeometryBatch(SDL_Renderer *renderer) : _renderer(renderer) {
+            _vertices.reserve(4096);
+            _indices.reserve(8192);
+        }
+
+        void GeometryBatch::setRenderer(SDL_Renderer *renderer) {
+            flush();
+            _renderer = renderer;
+        }
+
+        void GeometryBatch::setCounters(DrawCounters *counters) {
+            _counters = counters;
+        }
+
+        SDL_Renderer *GeometryBatch::renderer() const {
+            return _renderer;
+        }
+
+        void GeometryBatch::append(const SDL_Vertex *vertices, size_t vertex_count,
+                                   const int *indices, size_t index_count, SDL_Texture *texture) {
+            if (!vertices || !vertex_count || !indices || !index_count) return;
+            if (texture != _texture) {
+                flush();
+                _texture = texture;
+            }
+            /// `SDL_RenderGeometry` takes the vertex count as an int.
+            if (_vertices.size() - _run_vertex + vertex_count > static_cast<size_t>(std::numeric_limits<int>::max())) {
+                flush();
+            }
+            const int BASE = static_cast<int>(_vertices.size() - _run_vertex);
+            _vertices.insert(_vertices.end(), vertices, vertices + vertex_count);
+            const size_t OFFSET = _indices.size();
+            _indices.resize(OFFSET + index_count);
+            for (size_t i = 0; i < index_count; ++i) {
+                _indices[OFFSET + i] = indices[i] + BASE;
+            }
+        }
+
+        void GeometryBatch::flush() {
+            if (_capture) {
+                if (_indices.size() > _run_index) {
+                    _runs.push_back({_texture, _run_vertex, _vertices.size() - _run_vertex,
+                                     _run_index, _indices.size() - _run_index});
+                }
+                _run_vertex = _vertices.size();
+                _run_index = _indices.size();
+                return;
+            }
+            if (_indices.empty()) {
+                _vertices.clear();
+                return;
+            }
+            auto _ret = SDL_RenderGeometry(_renderer, _texture, _vertices.data(),
+                                           static_cast<int>(_vertices.size()), _indices.data(),
+                                           static_cast<int>(_indices.size()));
+            if (!_ret) {
+                Logger::log(std::format("Renderer: Set render geometry failed! Exception: {}",
+                                        SDL_GetError()), Logger::Error);
+            }
+            if (_counters) _counters->add(_vertices.size(), _indices.size());
+            clear();
+        }
+
+        void GeometryBatch::clear() {
+            _vertices.clear();
+            _indices.clear();
+            _runs.clear();
+            _run_vertex = _run_index = 0;
+        }
+
+        void GeometryBatch::setCaptureMode(bool enabled) {
+            if (enabled == _capture) return;
+            flush();
+            clear();
+            _capture = enabled;
+        }
+
+        bool GeometryBatch::captureMode() const {
+            return _capture;
+        }
+
+        const std::vector<GeometryBatch::Run> &GeometryBatch::runs() const {
+            return _runs;
+        }
+
+        const std::vector<SDL_Vertex> &GeometryBatch::vertices() const {
+            return _vertices;
+        }
+
+        const std::vector<int> &GeometryBatch::indices() const {
+            return _indices;
+        }
+
+        void GeometryBatch::takeCapture(std::vector<SDL_Vertex> &vertices, std::vector<int> &indices,
+                                        std::vector<Run> &runs) {
+            flush();
+            vertices = std::move(_vertices);
+            indices = std::move(_indices);
+            runs = std::move(_runs);
+            clear();
+        }
+
+        bool GeometryBatch::empty() const {
+            return _indices.size() == _run_index;
+        }
+
+        SDL_Texture *GeometryBatch::texture() const {
+            return _texture;
+        }
+
+        size_t GeometryBatch::vertexCount() const {
+            return _vertices.size();
+        }
+
+        size_t GeometryBatch::indexCount() const {
+            return _indices.size();
+        }
+    }
+}
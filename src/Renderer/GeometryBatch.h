@@ -0,0 +1,74 @@
+
+#ifndef MYENGINE_RENDERER_GEOMETRYBATCH_H
+#define MYENGINE_RENDERER_GEOMETRYBATCH_H
+#include "../Libs.h"
+
+namespace MyEngine {
+    namespace RenderCommand {
+        /// Work handed to SDL during a frame.
+        struct DrawCounters {
+            uint64_t draw_calls{0};
+            uint64_t vertices{0};
+            uint64_t indices{0};
+
+            void add(uint64_t vertex_count, uint64_t index_count) {
+                ++draw_calls;
+                vertices += vertex_count;
+                indices += index_count;
+            }
+            void reset() { *this = {}; }
+        };
+
+        /// Collects the color-baked vertices of consecutive shape and sprite
+        /// commands and submits each run sharing one texture (or none) with
+        /// a single `SDL_RenderGeometry` call.
+        class GeometryBatch {
+        public:
+            /// A range of captured geometry that is drawn with one call.
+            struct Run {
+                SDL_Texture* texture;
+                size_t first_vertex, vertex_count;
+                size_t first_index, index_count;
+            };
+
+            explicit GeometryBatch(SDL_Renderer* renderer = nullptr);
+            ~GeometryBatch() = default;
+
+            void setRenderer(SDL_Renderer* renderer);
+            void setCounters(DrawCounters* counters);
+            [[nodiscard]] SDL_Renderer* renderer() const;
+
+            void append(const SDL_Vertex* vertices, size_t vertex_count,
+                        const int* indices, size_t index_count, SDL_Texture* texture = nullptr);
+            void flush();
+            void clear();
+
+            /// In capture mode `flush()` closes the current run instead of drawing it,
+            /// so the geometry can be kept and submitted later.
+            void setCaptureMode(bool enabled);
+            [[nodiscard]] bool captureMode() const;
+            [[nodiscard]] const std::vector<Run>& runs() const;
+            [[nodiscard]] const std::vector<SDL_Vertex>& vertices() const;
+            [[nodiscard]] const std::vector<int>& indices() const;
+            /// Moves everything captured so far out of the batch.
+            void takeCapture(std::vector<SDL_Vertex>& vertices, std::vector<int>& indices,
+                             std::vector<Run>& runs);
+
+            [[nodiscard]] bool empty() const;
+            [[nodiscard]] SDL_Texture* texture() const;
+            [[nodiscard]] size_t vertexCount() const;
+            [[nodiscard]] size_t indexCount() const;
+        private:
+            SDL_Renderer* _renderer;
+            SDL_Texture* _texture{nullptr};
+            DrawCounters* _counters{nullptr};
+            std::vector<SDL_Vertex> _vertices;
+            std::vector<int> _indices;
+            std::vector<Run> _runs;
+            size_t _run_vertex{0}, _run_index{0};
+            bool _capture{false};
+        };
+    }
+}
+
+#endif //MYENGINE_RENDERER_GEOMETRYBATCH_H
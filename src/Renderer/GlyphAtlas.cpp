@@ -0,0 +1,259 @@
+#include "GlyphAtlas.h"
+#include "../Algorithm/Draw.h"
+#include "../Utils/Logger.h"
+
+namespace MyEngine {
+    namespace RenderCommand {
+        GlyphAtlas::GlyphAtlas(SDL_Renderer *renderer, int page_size, size_t page_limit)
+            : _renderer(renderer), _page_size(page_size), _page_limit(page_limit) {}
+
+        GlyphAtlas::~GlyphAtlas() {
+            clear();
+        }
+
+        GlyphAtlas::Page *GlyphAtlas::addPage() {
+            auto texture = SDL_CreateTexture(_renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC,
+                                             _page_size, _page_size);
+            if (!texture) {
+                Logger::log(std::format("GlyphAtlas: Create page texture failed! Exception: {}",
+                                        SDL_GetError()), Logger::Error);
+                return nullptr;
+            }
+            SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+            /// Static textures start out undefined; everything outside a glyph has to be clear.
+            _upload.assign(static_cast<size_t>(_page_size) * _page_size, 0);
+            SDL_UpdateTexture(texture, nullptr, _upload.data(), _page_size * 4);
+            _pages.push_back({texture});
+            return &_pages.back();
+        }
+
+        bool GlyphAtlas::pack(int width, int height, Page *&page, SDL_Point &pos) {
+            if (width > _page_size || height > _page_size) return false;
+            page = _pages.empty() ? nullptr : &_pages.back();
+            if (page && page->cursor_x + width > _page_size) {
+                page->shelf_y += page->shelf_height;
+                page->shelf_height = 0;
+                page->cursor_x = 0;
+            }
+            if (!page || page->shelf_y + height > _page_size) {
+                page = addPage();
+                if (!page) return false;
+            }
+            pos = {page->cursor_x, page->shelf_y};
+            page->cursor_x += width;
+            page->shelf_height = std::max(page->shelf_height, height);
+            return true;
+        }
+
+        void GlyphAtlas::sharpenSDF(size_t pixels) {
+            /// SDL_ttf puts the edge at 128 with a spread of 8 pixels, about 16 steps a pixel.
+            /// Mapping 32 steps to the full range leaves two pixels of anti-aliasing at the
+            /// rasterized size.
+            static constexpr auto LUT = [] {
+                std::array<uint8_t, 256> lut{};
+                for (int i = 0; i < 256; ++i) {
+                    lut[i] = static_cast<uint8_t>(std::clamp((i - 128) * 8 + 128, 0, 255));
+                }
+                return lut;
+            }();
+            auto bytes = reinterpret_cast<uint8_t*>(_upload.data());
+            for (size_t i = 0; i < pixels; ++i) {
+                /// RGBA32 keeps alpha in the last byte of each pixel regardless of endianness.
+                bytes[i * 4 + 3] = LUT[bytes[i * 4 + 3]];
+            }
+        }
+
+        void GlyphAtlas::updateGeneration(const TTF_Font *font, uint32_t generation) {
+            auto [it, inserted] = _generations.try_emplace(font, generation);
+            if (inserted || it->second == generation) return;
+            it->second = generation;
+            _digits.erase(font);
+            std::erase_if(_glyphs, [font, generation](const auto& item) {
+                return item.first.font == font && item.first.generation != generation;
+            });
+        }
+
+        const GlyphAtlas::Glyph &GlyphAtlas::glyph(TTF_Font *font, uint32_t codepoint) {
+            const Key KEY{font, TTF_GetFontGeneration(font), codepoint};
+            updateGeneration(font, KEY.generation);
+            auto it = _glyphs.find(KEY);
+            if (it != _glyphs.end()) return it->second;
+
+            Glyph& glyph = _glyphs[KEY];
+            TTF_GetGlyphMetrics(font, codepoint, nullptr, nullptr, nullptr, nullptr, &glyph.advance);
+            SDL_Surface* rendered = TTF_RenderGlyph_Blended(font, codepoint, StdColor::White);
+            if (!rendered) return glyph;
+            SDL_Surface* surface = rendered->format == SDL_PIXELFORMAT_RGBA32
+                                   ? rendered : SDL_ConvertSurface(rendered, SDL_PIXELFORMAT_RGBA32);
+            if (surface && surface->w > 0 && surface->h > 0) {
+                /// One clear pixel around every glyph keeps filtering from picking up its neighbours.
+                const int W = surface->w + 2, H = surface->h + 2;
+                Page* page;
+                SDL_Point pos;
+                if (pack(W, H, page, pos)) {
+                    _upload.assign(static_cast<size_t>(W) * H, 0);
+                    for (int y = 0; y < surface->h; ++y) {
+                        std::memcpy(_upload.data() + (y + 1) * W + 1,
+                                    static_cast<const std::byte*>(surface->pixels) + y * surface->pitch,
+                                    surface->w * 4);
+                    }
+                    if (TTF_GetFontSDF(font)) sharpenSDF(_upload.size());
+                    const SDL_Rect RECT{pos.x, pos.y, W, H};
+                    SDL_UpdateTexture(page->texture, &RECT, _upload.data(), W * 4);
+                    const float SIZE = static_cast<float>(_page_size);
+                    glyph.page = page->texture;
+                    glyph.uv = {(pos.x + 1) / SIZE, (pos.y + 1) / SIZE, surface->w / SIZE, surface->h / SIZE};
+                    glyph.width = static_cast<float>(surface->w);
+                    glyph.height = static_cast<float>(surface->h);
+                } else {
+                    Logger::log(std::format("GlyphAtlas: Glyph U+{:04X} does not fit into a page!", codepoint),
+                                Logger::Warn);
+                }
+            }
+            if (surface != rendered) SDL_DestroySurface(surface);
+            SDL_DestroySurface(rendered);
+            return glyph;
+        }
+
+        void GlyphAtlas::flush(const RenderContext &context) {
+            if (_indices.empty()) return;
+            context.renderGeometry(_vertices.data(), static_cast<int>(_vertices.size()),
+                                   _indices.data(), static_cast<int>(_indices.size()), _texture);
+            _vertices.clear();
+            _indices.clear();
+        }
+
+        void GlyphAtlas::addQuad(const RenderContext &context, const Glyph &glyph, float x, float y,
+                                 float scale, const SDL_FColor &color) {
+            if (glyph.page != _texture) {
+                flush(context);
+                _texture = glyph.page;
+            }
+            const int BASE = static_cast<int>(_vertices.size());
+            const float U0 = glyph.uv.x, V0 = glyph.uv.y;
+            const float U1 = glyph.uv.x + glyph.uv.w, V1 = glyph.uv.y + glyph.uv.h;
+            const float W = glyph.width * scale, H = glyph.height * scale;
+            _vertices.push_back({{x, y}, color, {U0, V0}});
+            _vertices.push_back({{x + W, y}, color, {U1, V0}});
+            _vertices.push_back({{x + W, y + H}, color, {U1, V1}});
+            _vertices.push_back({{x, y + H}, color, {U0, V1}});
+            for (int index : Algorithm::quadIndices<1>()) {
+                _indices.push_back(BASE + index);
+            }
+        }
+
+        static float fontScale(TTF_Font *font, float size) {
+            const float FONT_SIZE = TTF_GetFontSize(font);
+            return size > 0 && FONT_SIZE > 0 ? size / FONT_SIZE : 1.f;
+        }
+
+        void GlyphAtlas::draw(const RenderContext &context, TTF_Font *font, std::string_view text,
+                              const Vector2 &position, const SDL_Color &color, float size) {
+            if (!font || text.empty()) return;
+            const SDL_FColor FCOLOR = Algorithm::convert2FColor(color);
+            const float SCALE = fontScale(font, size);
+            const float LINE_SKIP = static_cast<float>(TTF_GetFontLineSkip(font)) * SCALE;
+            _texture = nullptr;
+            _vertices.clear();
+            _indices.clear();
+            float x = position.x, y = position.y;
+            uint32_t previous = 0;
+            const char* str = text.data();
+            size_t length = text.size();
+            while (length > 0) {
+                const uint32_t CODEPOINT = SDL_StepUTF8(&str, &length);
+                if (CODEPOINT == '\n') {
+                    x = position.x;
+                    y += LINE_SKIP;
+                    previous = 0;
+                    continue;
+                }
+                int kerning = 0;
+                if (previous && TTF_GetGlyphKerning(font, previous, CODEPOINT, &kerning)) {
+                    x += static_cast<float>(kerning) * SCALE;
+                }
+                previous = CODEPOINT;
+                const Glyph& glyph = this->glyph(font, CODEPOINT);
+                if (glyph.page) addQuad(context, glyph, x, y, SCALE, FCOLOR);
+                x += static_cast<float>(glyph.advance) * SCALE;
+            }
+            flush(context);
+        }
+
+        const GlyphAtlas::Digits &GlyphAtlas::digits(TTF_Font *font) {
+            const uint32_t GENERATION = TTF_GetFontGeneration(font);
+            /// Before taking the reference, as this may drop the table.
+            updateGeneration(font, GENERATION);
+            auto& digits = _digits[font];
+            if (digits.glyphs[0] && digits.generation == GENERATION) return digits;
+            digits.generation = GENERATION;
+            for (size_t i = 0; i < NUMBER_CHARS.size(); ++i) {
+                digits.glyphs[i] = &glyph(font, static_cast<uint32_t>(NUMBER_CHARS[i]));
+            }
+            return digits;
+        }
+
+        void GlyphAtlas::drawNumber(const RenderContext &context, TTF_Font *font, std::string_view text,
+                                    const Vector2 &position, const SDL_Color &color, float size) {
+            if (!font || text.empty()) return;
+            const auto& GLYPHS = digits(font).glyphs;
+            const SDL_FColor FCOLOR = Algorithm::convert2FColor(color);
+            const float SCALE = fontScale(font, size);
+            _texture = nullptr;
+            _vertices.clear();
+            _indices.clear();
+            float x = position.x;
+            for (char c : text) {
+                size_t index;
+                if (c >= '0' && c <= '9') index = c - '0';
+                else if (c == '+') index = 10;
+                else if (c == '-') index = 11;
+                else if (c == '.') index = 12;
+                else continue;
+                const Glyph& glyph = *GLYPHS[index];
+                if (glyph.page) addQuad(context, glyph, x, position.y, SCALE, FCOLOR);
+                x += static_cast<float>(glyph.advance) * SCALE;
+            }
+            flush(context);
+        }
+
+        void GlyphAtlas::removeFont(TTF_Font *font) {
+            _digits.erase(font);
+            _generations.erase(font);
+            std::erase_if(_glyphs, [font](const auto& item) { return item.first.font == font; });
+        }
+
+        void GlyphAtlas::clear() {
+            for (auto& page : _pages) {
+                SDL_DestroyTexture(page.texture);
+            }
+            _pages.clear();
+            _digits.clear();
+            _glyphs.clear();
+            _generations.clear();
+        }
+
+        void GlyphAtlas::trim() {
+            if (_pages.size() <= _page_limit) return;
+            Logger::log(std::format("GlyphAtlas: {} pages exceed the limit of {}, dropping every glyph.",
+                                    _pages.size(), _page_limit), Logger::Debug);
+            clear();
+        }
+
+        void GlyphAtlas::setPageLimit(size_t pages) {
+            _page_limit = pages;
+        }
+
+        size_t GlyphAtlas::pageLimit() const {
+            return _page_limit;
+        }
+
+        size_t GlyphAtlas::glyphCount() const {
+            return _glyphs.size();
+        }
+
+        size_t GlyphAtlas::pageCount() const {
+            return _pages.size();
+        }
+    }
+}
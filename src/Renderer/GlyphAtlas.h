@@ -0,0 +1,106 @@
+#ifndef MYENGINE_RENDERER_GLYPHATLAS_H
+#define MYENGINE_RENDERER_GLYPHATLAS_H
+#include "../Basic.h"
+#include "RenderContext.h"
+
+namespace MyEngine {
+    namespace RenderCommand {
+        /// Glyphs of every font drawn through it, rendered once and packed into shared
+        /// textures, so text turns into textured quads that batch like any other geometry.
+        /// Glyphs are rendered white and tinted by the vertex color.
+        ///
+        /// Glyphs of SDF fonts are stored as a steep alpha ramp around the distance field's
+        /// edge instead of the raw field, since `SDL_Renderer` can't threshold it per pixel.
+        /// With linear filtering they stay sharp over a wide range of sizes.
+        class GlyphAtlas {
+        public:
+            struct Glyph {
+                SDL_Texture* page{nullptr};
+                SDL_FRect uv{};
+                float width{0}, height{0};
+                int advance{0};
+            };
+
+            explicit GlyphAtlas(SDL_Renderer* renderer, int page_size = 1024, size_t page_limit = 8);
+            ~GlyphAtlas();
+            GlyphAtlas(const GlyphAtlas&) = delete;
+            GlyphAtlas& operator=(const GlyphAtlas&) = delete;
+
+            /// The glyph, rendered into a page first if it is new. Glyphs that have nothing
+            /// to draw or don't fit into a page have no page, only an advance.
+            const Glyph& glyph(TTF_Font* font, uint32_t codepoint);
+            /// Appends the quads of `text` to `context`, with the top-left corner of the
+            /// first line at `position`. Lines are broken at '\n' only. A `size` other than 0
+            /// scales the glyphs from the font's size to that point size.
+            void draw(const RenderContext& context, TTF_Font* font, std::string_view text,
+                      const Vector2& position, const SDL_Color& color, float size = 0);
+            /// Like `draw()` for a string made of "0123456789+-.", looked up in a per-font
+            /// table instead of decoded and hashed glyph by glyph. Kerning is not applied.
+            void drawNumber(const RenderContext& context, TTF_Font* font, std::string_view digits,
+                            const Vector2& position, const SDL_Color& color, float size = 0);
+            /// Forget the glyphs of `font`, which must be done before it is closed.
+            void removeFont(TTF_Font* font);
+            /// Drop every glyph and page.
+            void clear();
+            /// Starts over once more pages than the limit are in use, so a stream of new
+            /// glyphs can't grow the atlas forever. Only call it between frames, when no
+            /// recorded quad refers to a page.
+            void trim();
+            void setPageLimit(size_t pages);
+            [[nodiscard]] size_t pageLimit() const;
+
+            [[nodiscard]] size_t glyphCount() const;
+            [[nodiscard]] size_t pageCount() const;
+        private:
+            struct Key {
+                const TTF_Font* font;
+                uint32_t generation;
+                uint32_t codepoint;
+                bool operator==(const Key&) const = default;
+            };
+            struct KeyHash {
+                size_t operator()(const Key& key) const {
+                    return std::hash<const void*>()(key.font) ^
+                           (std::hash<uint64_t>()((static_cast<uint64_t>(key.generation) << 32) | key.codepoint) << 1);
+                }
+            };
+            /// Glyphs are packed left to right on shelves as tall as their tallest glyph.
+            struct Page {
+                SDL_Texture* texture;
+                int shelf_y{0}, shelf_height{0}, cursor_x{0};
+            };
+            /// Glyphs of `NUMBER_CHARS`, valid while the font's generation stays the same.
+            struct Digits {
+                uint32_t generation;
+                std::array<const Glyph*, 13> glyphs;
+            };
+            static constexpr std::string_view NUMBER_CHARS = "0123456789+-.";
+            const Digits& digits(TTF_Font* font);
+            /// Forgets the glyphs of older generations of `font` once a newer one shows up.
+            void updateGeneration(const TTF_Font* font, uint32_t generation);
+            bool pack(int width, int height, Page*& page, SDL_Point& pos);
+            /// Appends a quad to the pending geometry, drawing it first if the page changes.
+            void addQuad(const RenderContext& context, const Glyph& glyph, float x, float y, float scale,
+                         const SDL_FColor& color);
+            void flush(const RenderContext& context);
+            /// Turns the distance field in the alpha channel of `_upload` into coverage.
+            void sharpenSDF(size_t pixels);
+            Page* addPage();
+
+            SDL_Renderer* _renderer;
+            int _page_size;
+            size_t _page_limit;
+            std::vector<Page> _pages;
+            std::unordered_map<Key, Glyph, KeyHash> _glyphs;
+            std::unordered_map<const TTF_Font*, Digits> _digits;
+            /// The newest generation seen of every font.
+            std::unordered_map<const TTF_Font*, uint32_t> _generations;
+            std::vector<uint32_t> _upload;
+            std::vector<SDL_Vertex> _vertices;
+            std::vector<int> _indices;
+            SDL_Texture* _texture{nullptr};
+        };
+    }
+}
+
+#endif //MYENGINE_RENDERER_GLYPHATLAS_H
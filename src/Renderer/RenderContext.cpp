@@ -0,0 +1,85 @@
+
+#include "RenderContext.h"
+#include "../Utils/Logger.h"
+
+namespace MyEngine {
+    namespace RenderCommand {
+        void RenderContext::renderGeometry(const SDL_Vertex *vertices, int vertex_count,
+                                           const int *indices, int index_count, SDL_Texture *texture) const {
+            if (batch) {
+                batch->append(vertices, vertex_count, indices, index_count, texture);
+                return;
+            }
+            auto _ret = SDL_RenderGeometry(renderer, texture, vertices, vertex_count, indices, index_count);
+            countDraw(vertex_count, index_count);
+            if (!_ret) {
+                Logger::log(std::format("Renderer: Set render geometry failed! Exception: {}",
+                                        SDL_GetError()), Logger::Error);
+            }
+        }
+
+        void RenderContext::flushGeometry() const {
+            if (batch) batch->flush();
+        }
+
+        bool RenderContext::renderPoint(float x, float y, const SDL_Color &color) const {
+            if (capture) {
+                static constexpr int QUAD_INDICES[6] = { 0, 1, 2, 0, 2, 3 };
+                const SDL_FColor COLOR = {color.r / 255.f, color.g / 255.f, color.b / 255.f, color.a / 255.f};
+                const SDL_Vertex QUAD[4] = {{{x, y}, COLOR, {}}, {{x + 1.f, y}, COLOR, {}},
+                                            {{x + 1.f, y + 1.f}, COLOR, {}}, {{x, y + 1.f}, COLOR, {}}};
+                renderGeometry(QUAD, 4, QUAD_INDICES, 6);
+                return true;
+            }
+            flushGeometry();
+            if (!setDrawColor(color)) {
+                Logger::log(std::format("Renderer: Set renderer draw color failed! Exception: {}",
+                                        SDL_GetError()), Logger::Warn);
+            }
+            countDraw(1);
+            return SDL_RenderPoint(renderer, x, y);
+        }
+
+        bool RenderContext::renderLine(float x1, float y1, float x2, float y2, const SDL_Color &color) const {
+            if (capture) {
+                static constexpr int QUAD_INDICES[6] = { 0, 1, 2, 0, 2, 3 };
+                const float DX = x2 - x1, DY = y2 - y1;
+                const float LENGTH = std::sqrt(DX * DX + DY * DY);
+                if (LENGTH == 0.f) return renderPoint(x1, y1, color);
+                const float NX = -DY / LENGTH * 0.5f, NY = DX / LENGTH * 0.5f;
+                const SDL_FColor COLOR = {color.r / 255.f, color.g / 255.f, color.b / 255.f, color.a / 255.f};
+                const SDL_Vertex QUAD[4] = {{{x1 + NX, y1 + NY}, COLOR, {}}, {{x2 + NX, y2 + NY}, COLOR, {}},
+                                            {{x2 - NX, y2 - NY}, COLOR, {}}, {{x1 - NX, y1 - NY}, COLOR, {}}};
+                renderGeometry(QUAD, 4, QUAD_INDICES, 6);
+                return true;
+            }
+            flushGeometry();
+            if (!setDrawColor(color)) {
+                Logger::log(std::format("Renderer: Set render draw color failed! Exception: {}",
+                                        SDL_GetError()), Logger::Warn);
+            }
+            countDraw(2);
+            return SDL_RenderLine(renderer, x1, y1, x2, y2);
+        }
+
+        bool RenderContext::setDrawColor(const SDL_Color &color) const {
+            if (state) return state->setDrawColor(color);
+            return SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
+        }
+
+        bool RenderContext::setDrawBlendMode(SDL_BlendMode blend_mode) const {
+            if (state) return state->setDrawBlendMode(blend_mode);
+            return SDL_SetRenderDrawBlendMode(renderer, blend_mode);
+        }
+
+        bool RenderContext::setViewport(const SDL_Rect *rect) const {
+            if (state) return state->setViewport(rect);
+            return SDL_SetRenderViewport(renderer, rect);
+        }
+
+        bool RenderContext::setClipRect(const SDL_Rect *rect) const {
+            if (state) return state->setClipRect(rect);
+            return SDL_SetRenderClipRect(renderer, rect);
+        }
+    }
+}
@@ -0,0 +1,38 @@
+
+#ifndef MYENGINE_RENDERER_RENDERCONTEXT_H
+#define MYENGINE_RENDERER_RENDERCONTEXT_H
+#include "GeometryBatch.h"
+#include "StateCache.h"
+
+namespace MyEngine {
+    namespace RenderCommand {
+        /// Everything a command needs while it is executed by the renderer.
+        struct RenderContext {
+            SDL_Renderer* renderer{nullptr};
+            GeometryBatch* batch{nullptr};
+            StateCache* state{nullptr};
+            /// Set while a `RenderList` is recorded or draws are snapshotted: everything
+            /// has to end up in `batch`.
+            bool capture{false};
+            DrawCounters* counters{nullptr};
+
+            void renderGeometry(const SDL_Vertex* vertices, int vertex_count,
+                                const int* indices, int index_count, SDL_Texture* texture = nullptr) const;
+            void flushGeometry() const;
+            /// Count a draw call that went to SDL without passing through `batch`.
+            void countDraw(uint64_t vertex_count = 0, uint64_t index_count = 0) const {
+                if (counters) counters->add(vertex_count, index_count);
+            }
+            /// One pixel wide primitives. Drawn directly unless capturing, in which case
+            /// they are turned into geometry.
+            bool renderPoint(float x, float y, const SDL_Color& color) const;
+            bool renderLine(float x1, float y1, float x2, float y2, const SDL_Color& color) const;
+            bool setDrawColor(const SDL_Color& color) const;
+            bool setDrawBlendMode(SDL_BlendMode blend_mode) const;
+            bool setViewport(const SDL_Rect* rect) const;
+            bool setClipRect(const SDL_Rect* rect) const;
+        };
+    }
+}
+
+#endif //MYENGINE_RENDERER_RENDERCONTEXT_H
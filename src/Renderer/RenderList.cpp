@@ -0,0 +1,94 @@
+
+#include "RenderList.h"
+#include "../Utils/Logger.h"
+
+namespace MyEngine {
+    namespace RenderCommand {
+        RenderList::RenderList(size_t block_size) : _buffer(block_size) {}
+
+        void RenderList::markDirty() {
+            _dirty = true;
+        }
+
+        bool RenderList::dirty() const {
+            return _dirty;
+        }
+
+        bool RenderList::empty() const {
+            return _steps.empty();
+        }
+
+        void RenderList::clear() {
+            _steps.clear();
+            _vertices.clear();
+            _indices.clear();
+            _run_count = 0;
+            _sets_blend_mode = false;
+            _sets_view = false;
+            _buffer.clear();
+            _dirty = true;
+        }
+
+        size_t RenderList::vertexCount() const {
+            return _vertices.size();
+        }
+
+        size_t RenderList::indexCount() const {
+            return _indices.size();
+        }
+
+        size_t RenderList::runCount() const {
+            return _run_count;
+        }
+
+        void RenderList::compile(SDL_Renderer *renderer) {
+            GeometryBatch capture(renderer);
+            capture.setCaptureMode(true);
+            const RenderContext CONTEXT{renderer, &capture, nullptr, true};
+            _steps.clear();
+            size_t taken = 0;
+            const auto take_runs = [&] {
+                capture.flush();
+                const auto& runs = capture.runs();
+                for (; taken < runs.size(); ++taken) {
+                    _steps.push_back({nullptr, runs[taken]});
+                }
+            };
+            for (auto header : _buffer.records()) {
+                if (header->flags & CommandHeader::Batchable) {
+                    execute(header, CONTEXT);
+                    continue;
+                }
+                take_runs();
+                _steps.push_back({header, {}});
+            }
+            take_runs();
+            _run_count = taken;
+            std::vector<GeometryBatch::Run> runs;
+            capture.takeCapture(_vertices, _indices, runs);
+            _dirty = false;
+        }
+
+        void RenderList::replay(const RenderContext &context) const {
+            for (auto& step : _steps) {
+                if (step.record) {
+                    execute(step.record, context);
+                    continue;
+                }
+                /// Geometry a replayed command left in the batch has to be drawn first.
+                context.flushGeometry();
+                auto& run = step.run;
+                auto _ret = SDL_RenderGeometry(context.renderer, run.texture,
+                                               _vertices.data() + run.first_vertex,
+                                               static_cast<int>(run.vertex_count),
+                                               _indices.data() + run.first_index,
+                                               static_cast<int>(run.index_count));
+                context.countDraw(run.vertex_count, run.index_count);
+                if (!_ret) {
+                    Logger::log(std::format("Renderer: Set render geometry failed! Exception: {}",
+                                            SDL_GetError()), Logger::Error);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,56 @@
+
+#ifndef MYENGINE_RENDERER_RENDERLIST_H
+#define MYENGINE_RENDERER_RENDERLIST_H
+#include "CommandBuffer.h"
+
+namespace MyEngine {
+    class CommandRecorder;
+
+    namespace RenderCommand {
+        /// A recorded sequence of draw calls that can be drawn again every frame.
+        /// Shape and texture draws are turned into vertex data once, when recording
+        /// ends; everything else is kept as a command and executed on replay.
+        /// Textures and texts drawn into the list have to outlive it.
+        class RenderList {
+            friend class MyEngine::CommandRecorder;
+        public:
+            explicit RenderList(size_t block_size = 16 * 1024);
+            ~RenderList() = default;
+            RenderList(const RenderList&) = delete;
+            RenderList& operator=(const RenderList&) = delete;
+
+            /// Flag the content as outdated; it is still drawn until it is recorded again.
+            void markDirty();
+            [[nodiscard]] bool dirty() const;
+            [[nodiscard]] bool empty() const;
+            void clear();
+
+            [[nodiscard]] size_t vertexCount() const;
+            [[nodiscard]] size_t indexCount() const;
+            /// Count of geometry runs, i.e. `SDL_RenderGeometry` calls per replay.
+            [[nodiscard]] size_t runCount() const;
+
+            void replay(const RenderContext& context) const;
+        private:
+            struct Step {
+                /// `nullptr` for a geometry run.
+                const CommandHeader* record;
+                GeometryBatch::Run run;
+            };
+            void compile(SDL_Renderer* renderer);
+
+            CommandBuffer _buffer;
+            std::vector<SDL_Vertex> _vertices;
+            std::vector<int> _indices;
+            std::vector<Step> _steps;
+            size_t _run_count{0};
+            SDL_BlendMode _blend_mode{SDL_BLENDMODE_NONE};
+            bool _sets_blend_mode{false};
+            /// Sets the viewport or clip, or runs custom commands that might.
+            bool _sets_view{false};
+            bool _dirty{true};
+        };
+    }
+}
+
+#endif //MYENGINE_RENDERER_RENDERLIST_H
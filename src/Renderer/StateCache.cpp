@@ -0,0 +1,87 @@
+
+#include "StateCache.h"
+
+namespace MyEngine {
+    namespace RenderCommand {
+        StateCache::StateCache(SDL_Renderer *renderer) : _renderer(renderer) {}
+
+        void StateCache::setRenderer(SDL_Renderer *renderer) {
+            _renderer = renderer;
+            invalidate();
+        }
+
+        void StateCache::invalidate() {
+            _draw_color_valid = false;
+            _blend_mode_valid = false;
+            _viewport_valid = false;
+            _clip_rect_valid = false;
+        }
+
+        bool StateCache::setDrawColor(const SDL_Color &color) {
+            if (_draw_color_valid && _draw_color.r == color.r && _draw_color.g == color.g &&
+                _draw_color.b == color.b && _draw_color.a == color.a) {
+                ++_skipped;
+                return true;
+            }
+            ++_issued;
+            _draw_color_valid = SDL_SetRenderDrawColor(_renderer, color.r, color.g, color.b, color.a);
+            _draw_color = color;
+            return _draw_color_valid;
+        }
+
+        bool StateCache::setDrawBlendMode(SDL_BlendMode blend_mode) {
+            if (_blend_mode_valid && _blend_mode == blend_mode) {
+                ++_skipped;
+                return true;
+            }
+            ++_issued;
+            _blend_mode_valid = SDL_SetRenderDrawBlendMode(_renderer, blend_mode);
+            _blend_mode = blend_mode;
+            return _blend_mode_valid;
+        }
+
+        bool StateCache::setViewport(const SDL_Rect *rect) {
+            if (sameRect(_viewport_valid, _viewport_reset, _viewport, rect)) {
+                ++_skipped;
+                return true;
+            }
+            ++_issued;
+            _viewport_valid = SDL_SetRenderViewport(_renderer, rect);
+            _viewport_reset = (rect == nullptr);
+            if (rect) _viewport = *rect;
+            return _viewport_valid;
+        }
+
+        bool StateCache::setClipRect(const SDL_Rect *rect) {
+            if (sameRect(_clip_rect_valid, _clip_rect_reset, _clip_rect, rect)) {
+                ++_skipped;
+                return true;
+            }
+            ++_issued;
+            _clip_rect_valid = SDL_SetRenderClipRect(_renderer, rect);
+            _clip_rect_reset = (rect == nullptr);
+            if (rect) _clip_rect = *rect;
+            return _clip_rect_valid;
+        }
+
+        uint64_t StateCache::issuedCount() const {
+            return _issued;
+        }
+
+        uint64_t StateCache::skippedCount() const {
+            return _skipped;
+        }
+
+        void StateCache::resetCounters() {
+            _issued = 0;
+            _skipped = 0;
+        }
+
+        bool StateCache::sameRect(bool valid, bool reset, const SDL_Rect &cached, const SDL_Rect *rect) {
+            if (!valid) return false;
+            if (!rect) return reset;
+            return !reset && cached.x == rect->x && cached.y == rect->y &&
+                   cached.w == rect->w && cached.h == rect->h;
+        }
+    }
+}
@@ -0,0 +1,43 @@
+
+#ifndef MYENGINE_RENDERER_STATECACHE_H
+#define MYENGINE_RENDERER_STATECACHE_H
+#include "../Libs.h"
+
+namespace MyEngine {
+    namespace RenderCommand {
+        /// Remembers the last render state sent to SDL and skips calls that
+        /// would set the same value again.
+        class StateCache {
+        public:
+            explicit StateCache(SDL_Renderer* renderer = nullptr);
+            ~StateCache() = default;
+
+            void setRenderer(SDL_Renderer* renderer);
+            /// Forget everything, e.g. after foreign code touched the renderer.
+            void invalidate();
+
+            bool setDrawColor(const SDL_Color& color);
+            bool setDrawBlendMode(SDL_BlendMode blend_mode);
+            bool setViewport(const SDL_Rect* rect);
+            bool setClipRect(const SDL_Rect* rect);
+
+            [[nodiscard]] uint64_t issuedCount() const;
+            [[nodiscard]] uint64_t skippedCount() const;
+            void resetCounters();
+        private:
+            static bool sameRect(bool valid, bool reset, const SDL_Rect& cached, const SDL_Rect* rect);
+
+            SDL_Renderer* _renderer;
+            SDL_Color _draw_color{};
+            SDL_BlendMode _blend_mode{};
+            SDL_Rect _viewport{}, _clip_rect{};
+            bool _draw_color_valid{false}, _blend_mode_valid{false},
+                 _viewport_valid{false}, _clip_rect_valid{false};
+            /// Remembers whether the cached viewport/clip rect is the reset (nullptr) state.
+            bool _viewport_reset{false}, _clip_rect_reset{false};
+            uint64_t _issued{0}, _skipped{0};
+        };
+    }
+}
+
+#endif //MYENGINE_RENDERER_STATECACHE_H
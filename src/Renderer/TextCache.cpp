@@ -0,0 +1,184 @@
+#include "TextCache.h"
+#include "../Algorithm/Draw.h"
+#include "../Utils/Logger.h"
+
+namespace MyEngine {
+    namespace RenderCommand {
+        size_t TextCache::KeyHash::operator()(const Key& key) const {
+            size_t hash = std::hash<std::string_view>()(key.text);
+            auto combine = [&hash](size_t value) {
+                hash ^= value + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+            };
+            combine(std::hash<const void*>()(key.font));
+            combine(std::hash<float>()(key.size));
+            combine(static_cast<size_t>((static_cast<uint64_t>(key.style) << 32) | static_cast<uint32_t>(key.outline)));
+            combine(static_cast<size_t>(key.color.r) | key.color.g << 8 | key.color.b << 16 |
+                    static_cast<size_t>(key.color.a) << 24);
+            return hash;
+        }
+
+        TextCache::TextCache(SDL_Renderer* renderer, size_t budget)
+            : _renderer(renderer), _budget(budget) {}
+
+        TextCache::~TextCache() {
+            clear();
+        }
+
+        void TextCache::setRenderer(SDL_Renderer* renderer) {
+            if (renderer == _renderer) return;
+            clear();
+            std::lock_guard lock(_mutex);
+            _renderer = renderer;
+        }
+
+        void TextCache::setBudget(size_t bytes) {
+            std::lock_guard lock(_mutex);
+            _budget = bytes;
+            evict();
+        }
+
+        size_t TextCache::budget() const {
+            std::lock_guard lock(_mutex);
+            return _budget;
+        }
+
+        TextCache::Entry* TextCache::acquire(TTF_Font* font, std::string_view text, const SDL_Color& color,
+                                             uint64_t frame, Size& size) {
+            size = Size();
+            if (!font || text.empty()) return nullptr;
+            /// The key only views `text`, so a hit allocates nothing.
+            const Key KEY{font, TTF_GetFontSize(font), static_cast<uint32_t>(TTF_GetFontStyle(font)),
+                          TTF_GetFontOutline(font), color, text};
+            std::lock_guard lock(_mutex);
+            auto it = _entries.find(KEY);
+            if (it != _entries.end()) {
+                ++_stats.hits;
+                Entry& entry = *it->second;
+                entry.frame = frame;
+                size = entry.size;
+                _lru.splice(_lru.begin(), _lru, it->second);
+                return &entry;
+            }
+            ++_stats.misses;
+            _lru.emplace_front();
+            Entry& entry = _lru.front();
+            entry.text = text;
+            entry.key = KEY;
+            entry.key.text = entry.text;
+            entry.frame = frame;
+            _entries.emplace(entry.key, _lru.begin());
+            ++_stats.entries;
+            return &entry;
+        }
+
+        void TextCache::draw(const RenderContext& context, Entry* entry, const Vector2& position) {
+            if (!entry) return;
+            SDL_Texture* texture;
+            Size size;
+            {
+                std::lock_guard lock(_mutex);
+                if (!entry->texture && !entry->failed && !entry->dead && _renderer) {
+                    const Key& KEY = entry->key;
+                    SDL_Surface* surface = TTF_RenderText_Blended(KEY.font, KEY.text.data(), KEY.text.size(),
+                                                                  KEY.color);
+                    if (surface) {
+                        entry->texture = SDL_CreateTextureFromSurface(_renderer, surface);
+                        entry->size = Size(static_cast<float>(surface->w), static_cast<float>(surface->h));
+                        SDL_DestroySurface(surface);
+                    }
+                    if (entry->texture) {
+                        entry->bytes = static_cast<size_t>(entry->size.width * entry->size.height) * 4;
+                        _stats.bytes += entry->bytes;
+                    } else {
+                        /// Not retried every frame; the entry is dropped like any other.
+                        entry->failed = true;
+                        entry->size = Size();
+                        Logger::log(std::format("TextCache: Render text failed! Exception: {}", SDL_GetError()),
+                                    Logger::Error);
+                    }
+                }
+                texture = entry->texture;
+                size = entry->size;
+            }
+            if (!texture) return;
+            static constexpr SDL_FColor WHITE{1.f, 1.f, 1.f, 1.f};
+            const float X = position.x, Y = position.y;
+            const SDL_Vertex VERTICES[4]{
+                {{X, Y}, WHITE, {0, 0}},
+                {{X + size.width, Y}, WHITE, {1, 0}},
+                {{X + size.width, Y + size.height}, WHITE, {1, 1}},
+                {{X, Y + size.height}, WHITE, {0, 1}}
+            };
+            const auto& INDICES = Algorithm::quadIndices<1>();
+            context.renderGeometry(VERTICES, 4, INDICES.data(), static_cast<int>(INDICES.size()), texture);
+        }
+
+        void TextCache::collect(uint64_t rendered) {
+            std::lock_guard lock(_mutex);
+            _collected = std::max(_collected, rendered + 1);
+            evict();
+            for (auto it = _garbage.begin(); it != _garbage.end();) {
+                auto next = std::next(it);
+                if (it->frame < _collected) {
+                    if (it->texture) SDL_DestroyTexture(it->texture);
+                    _garbage.erase(it);
+                }
+                it = next;
+            }
+        }
+
+        void TextCache::evict() {
+            while (_stats.bytes > _budget && !_lru.empty()) {
+                auto last = std::prev(_lru.end());
+                /// Everything in front of it was drawn at least as recently.
+                if (last->frame >= _collected) break;
+                drop(last);
+                ++_stats.evictions;
+            }
+        }
+
+        void TextCache::drop(EntryList::iterator entry) {
+            _stats.bytes -= entry->bytes;
+            --_stats.entries;
+            _entries.erase(_entries.find(entry->key));
+            _garbage.splice(_garbage.end(), _lru, entry);
+        }
+
+        void TextCache::removeFont(TTF_Font* font) {
+            std::lock_guard lock(_mutex);
+            for (auto it = _lru.begin(); it != _lru.end();) {
+                auto next = std::next(it);
+                if (it->key.font == font) {
+                    it->dead = true;
+                    drop(it);
+                }
+                it = next;
+            }
+        }
+
+        void TextCache::clear() {
+            std::lock_guard lock(_mutex);
+            for (auto list : {&_lru, &_garbage}) {
+                for (auto& entry : *list) {
+                    if (entry.texture) SDL_DestroyTexture(entry.texture);
+                }
+                list->clear();
+            }
+            _entries.clear();
+            _stats.bytes = 0;
+            _stats.entries = 0;
+        }
+
+        TextCache::Stats TextCache::stats() const {
+            std::lock_guard lock(_mutex);
+            return _stats;
+        }
+
+        void TextCache::resetStats() {
+            std::lock_guard lock(_mutex);
+            _stats.hits = 0;
+            _stats.misses = 0;
+            _stats.evictions = 0;
+        }
+    }
+}
@@ -0,0 +1,101 @@
+#ifndef MYENGINE_RENDERER_TEXTCACHE_H
+#define MYENGINE_RENDERER_TEXTCACHE_H
+#include "../Basic.h"
+#include "RenderContext.h"
+
+namespace MyEngine {
+    namespace RenderCommand {
+        /// Rendered textures of whole strings, for labels that are drawn every frame but
+        /// rarely change. Entries are keyed by font, size, style, color and string, and the
+        /// least recently used ones are dropped once the cache outgrows its byte budget.
+        ///
+        /// Entries are reserved while recording, from any thread, and their textures are
+        /// created when the frame is rendered. Textures are only destroyed in `collect()`,
+        /// once no recorded frame can still draw them.
+        class TextCache {
+        public:
+            struct Stats {
+                uint64_t hits{0}, misses{0}, evictions{0};
+                size_t bytes{0}, entries{0};
+            };
+            struct Entry;
+
+            explicit TextCache(SDL_Renderer* renderer = nullptr, size_t budget = 32 * 1024 * 1024);
+            ~TextCache();
+            TextCache(const TextCache&) = delete;
+            TextCache& operator=(const TextCache&) = delete;
+
+            void setRenderer(SDL_Renderer* renderer);
+            /// Entries over the new budget are dropped at the next `collect()`.
+            void setBudget(size_t bytes);
+            [[nodiscard]] size_t budget() const;
+            /// The entry of `text` in `font`, reserved first if it isn't cached, marked as
+            /// drawn in frame `frame`. `size` is set to the size of its texture, or to 0 if
+            /// it is not rendered yet. Doesn't touch the renderer.
+            Entry* acquire(TTF_Font* font, std::string_view text, const SDL_Color& color, uint64_t frame,
+                           Size& size);
+            /// Draws the texture of `entry` at `position`, rendering it first if needed.
+            void draw(const RenderContext& context, Entry* entry, const Vector2& position);
+            /// Destroys the textures of dropped entries that were last drawn in frame
+            /// `rendered` or before, which has to be rendered already.
+            void collect(uint64_t rendered);
+            /// Drop the entries of `font`, which must be done before it is closed. Recorded
+            /// frames still draw the ones already rendered, and skip the others.
+            void removeFont(TTF_Font* font);
+            /// Destroys every texture at once; only call it when no recorded frame is left.
+            void clear();
+
+            [[nodiscard]] Stats stats() const;
+            void resetStats();
+
+            struct Key {
+                TTF_Font* font;
+                float size;
+                uint32_t style;
+                int outline;
+                SDL_Color color;
+                /// Points into the entry's own copy of the string.
+                std::string_view text;
+                bool operator==(const Key& other) const {
+                    return font == other.font && size == other.size && style == other.style &&
+                           outline == other.outline && color.r == other.color.r && color.g == other.color.g &&
+                           color.b == other.color.b && color.a == other.color.a && text == other.text;
+                }
+            };
+            struct Entry {
+                Key key;
+                std::string text;
+                SDL_Texture* texture{nullptr};
+                Size size;
+                size_t bytes{0};
+                uint64_t frame{0};
+                /// The font was removed before the texture was rendered.
+                bool dead{false};
+                bool failed{false};
+            };
+        private:
+            struct KeyHash {
+                size_t operator()(const Key& key) const;
+            };
+            using EntryList = std::list<Entry>;
+            /// Moves entries from the back of `_lru` to `_garbage` until the budget is met
+            /// or only entries of frames that are not rendered yet are left.
+            void evict();
+            void drop(EntryList::iterator entry);
+
+            mutable std::mutex _mutex;
+            SDL_Renderer* _renderer;
+            size_t _budget;
+            /// Frames before this one are rendered.
+            uint64_t _collected{0};
+            /// Most recently used entry first.
+            EntryList _lru;
+            /// Dropped entries whose textures are destroyed by `collect()`.
+            EntryList _garbage;
+            std::unordered_map<Key, EntryList::iterator, KeyHash> _entries;
+            Stats _stats;
+        };
+    }
+}
+
+#endif //MYENGINE_RENDERER_TEXTCACHE_H
@@ -0,0 +1,110 @@
+#include "TextureLoader.h"
+
+namespace MyEngine {
+    namespace RenderCommand {
+        static uint32_t loaderThreads(uint32_t threads) {
+            const uint32_t HARDWARE = std::max(1u, std::thread::hardware_concurrency());
+            return std::clamp(threads, 1u, HARDWARE);
+        }
+
+        TextureLoader::TextureLoader(uint32_t threads) : _pool(1024, loaderThreads(threads)) {}
+
+        TextureLoader::~TextureLoader() {
+            _pool.stopAll();
+            for (auto& decoded : _decoded) {
+                if (decoded.surface) SDL_DestroySurface(decoded.surface);
+            }
+        }
+
+        uint64_t TextureLoader::load(const std::string& path, Callback callback) {
+            uint64_t id;
+            {
+                std::lock_guard lock(_mutex);
+                id = _next_id++;
+                _callbacks.emplace(id, std::move(callback));
+            }
+            _pool.append([this, id, path] {
+                {
+                    /// Cancelled before a worker got to it.
+                    std::lock_guard lock(_mutex);
+                    if (!_callbacks.contains(id)) return;
+                }
+                SDL_Surface* surface = IMG_Load(path.c_str());
+                if (!surface) {
+                    Logger::log(std::format("TextureLoader: The image path '{}' is not found!", path), Logger::Error);
+                }
+                std::lock_guard lock(_mutex);
+                if (!_callbacks.contains(id)) {
+                    if (surface) SDL_DestroySurface(surface);
+                    return;
+                }
+                _decoded.push_back({id, surface});
+            });
+            return id;
+        }
+
+        void TextureLoader::cancel(uint64_t id) {
+            std::lock_guard lock(_mutex);
+            _callbacks.erase(id);
+            for (auto it = _decoded.begin(); it != _decoded.end(); ++it) {
+                if (it->id != id) continue;
+                if (it->surface) SDL_DestroySurface(it->surface);
+                _decoded.erase(it);
+                break;
+            }
+        }
+
+        void TextureLoader::upload() {
+            const uint64_t START = SDL_GetPerformanceCounter();
+            const uint64_t FREQUENCY = SDL_GetPerformanceFrequency();
+            size_t bytes = 0;
+            bool first = true;
+            while (true) {
+                Decoded decoded;
+                Callback callback;
+                {
+                    std::lock_guard lock(_mutex);
+                    if (_decoded.empty()) return;
+                    const size_t SIZE = _decoded.front().surface
+                            ? static_cast<size_t>(_decoded.front().surface->pitch) * _decoded.front().surface->h : 0;
+                    const uint64_t ELAPSED = (SDL_GetPerformanceCounter() - START) * 1000000 / FREQUENCY;
+                    if (!first && (bytes + SIZE > _budget_bytes || ELAPSED >= _budget_us)) return;
+                    decoded = _decoded.front();
+                    _decoded.pop_front();
+                    auto it = _callbacks.find(decoded.id);
+                    callback = std::move(it->second);
+                    _callbacks.erase(it);
+                    bytes += SIZE;
+                }
+                first = false;
+                /// Outside the lock, so the callback may load or cancel other images.
+                if (callback) {
+                    callback(decoded.surface);
+                } else if (decoded.surface) {
+                    SDL_DestroySurface(decoded.surface);
+                }
+            }
+        }
+
+        void TextureLoader::setBudget(uint64_t microseconds, size_t bytes) {
+            std::lock_guard lock(_mutex);
+            _budget_us = microseconds;
+            _budget_bytes = bytes;
+        }
+
+        uint64_t TextureLoader::timeBudget() const {
+            std::lock_guard lock(_mutex);
+            return _budget_us;
+        }
+
+        size_t TextureLoader::byteBudget() const {
+            std::lock_guard lock(_mutex);
+            return _budget_bytes;
+        }
+
+        size_t TextureLoader::pendingCount() const {
+            std::lock_guard lock(_mutex);
+            return _callbacks.size();
+        }
+    }
+}
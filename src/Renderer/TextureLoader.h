@@ -0,0 +1,51 @@
+#ifndef MYENGINE_RENDERER_TEXTURELOADER_H
+#define MYENGINE_RENDERER_TEXTURELOADER_H
+#include "../Basic.h"
+#include "../MultiThread/ThreadPool.h"
+
+namespace MyEngine {
+    namespace RenderCommand {
+        /// Decodes images on worker threads and hands them back on the render thread, a
+        /// few per frame, so loading a level doesn't stall the frames drawn meanwhile.
+        class TextureLoader {
+        public:
+            /// Called on the render thread with the decoded image, or nullptr if it could
+            /// not be loaded. The callback takes over the surface.
+            using Callback = std::function<void(SDL_Surface*)>;
+
+            explicit TextureLoader(uint32_t threads = 2);
+            ~TextureLoader();
+            TextureLoader(const TextureLoader&) = delete;
+            TextureLoader& operator=(const TextureLoader&) = delete;
+
+            /// Starts decoding `path` and returns the id of the request.
+            uint64_t load(const std::string& path, Callback callback);
+            /// The callback of a cancelled request is never called.
+            void cancel(uint64_t id);
+            /// Runs the callbacks of decoded images until the time or byte budget of the
+            /// frame is used up. The first one always runs, so a large image still gets in.
+            void upload();
+            void setBudget(uint64_t microseconds, size_t bytes);
+            [[nodiscard]] uint64_t timeBudget() const;
+            [[nodiscard]] size_t byteBudget() const;
+            /// Requests that were neither handed back nor cancelled yet.
+            [[nodiscard]] size_t pendingCount() const;
+        private:
+            struct Decoded {
+                uint64_t id;
+                SDL_Surface* surface;
+            };
+
+            mutable std::mutex _mutex;
+            std::unordered_map<uint64_t, Callback> _callbacks;
+            std::deque<Decoded> _decoded;
+            uint64_t _next_id{1};
+            uint64_t _budget_us{2000};
+            size_t _budget_bytes{16 * 1024 * 1024};
+            /// Declared last, so the workers are joined before anything they touch goes away.
+            ThreadPool _pool;
+        };
+    }
+}
+
+#endif //MYENGINE_RENDERER_TEXTURELOADER_H
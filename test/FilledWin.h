@@ -28,7 +28,12 @@ protected:
 
     void paintEvent() override {
         MyEngine::Window::paintEvent();
-        renderer()->drawTexture(_texture->self(), _props);
+        if (_tiles.dirty()) {
+            renderer()->beginRecord(&_tiles);
+            renderer()->drawTexture(_texture->self(), _props);
+            renderer()->endRecord();
+        }
+        renderer()->drawRenderList(&_tiles);
         renderer()->drawDebugFPS({20, 30}, MyEngine::RGBAColor::RedBegonia);
     }
 
@@ -39,6 +44,7 @@ protected:
         auto rows = h / block_size.height + 1;
         int count = static_cast<int>(rows * cols);
         if (count <= _props.size()) return;
+        _tiles.markDirty();
         for (int i = 0; i < count; ++i) {
             int r = i / (int)cols;
             int c = i % (int)cols;
@@ -57,6 +63,7 @@ protected:
 private:
     MyEngine::Texture* _texture;
     std::vector<MyEngine::TextureProperty*> _props;
+    MyEngine::RenderList _tiles;
 };
 
 